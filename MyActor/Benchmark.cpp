@@ -0,0 +1,884 @@
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include "./actor/my_actor.h"
+#include "./actor/async_timer.h"
+#include "./actor/generator.h"
+#include "./actor/actor_socket.h"
+
+/*!
+@brief ԵĲ״̬ÿִbatchβ
+*/
+struct bench_sample
+{
+	bench_sample(size_t batch, size_t samples, size_t warmup)
+	:_batch(batch), _samples(samples), _warmup(warmup), _tick(0), _skipReason(NULL)
+	{
+		_times.reserve(samples);
+	}
+
+	/*!
+	@brief ʼһ
+	*/
+	void begin()
+	{
+		_tick = get_tick_ns();
+	}
+
+	/*!
+	@brief һԤ¼
+	@return true Ҫ, false 
+	*/
+	bool end()
+	{
+		const long long tk = get_tick_ns() - _tick;
+		if (_warmup)
+		{
+			_warmup--;
+		}
+		else
+		{
+			_times.push_back(tk);
+		}
+		return _times.size() < _samples;
+	}
+
+	/*!
+	@brief ޷(Դ)
+	*/
+	void skip(const char* reason)
+	{
+		_skipReason = reason;
+	}
+
+	const size_t _batch;
+	const size_t _samples;
+	size_t _warmup;
+	long long _tick;
+	const char* _skipReason;
+	std::vector<long long> _times;
+};
+
+struct bench_case
+{
+	const char* _name;
+	size_t _batch;
+	void(*_func)(bench_sample& bs);
+};
+
+struct bench_result
+{
+	const char* _name;
+	const char* _skipReason;//NULLʾûͳֵЧ
+	size_t _batch;
+	size_t _samples;
+	double _min;
+	double _p50;
+	double _p90;
+	double _p99;
+	double _max;
+	double _mean;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/*!
+@brief actorл(tick_yield)
+*/
+static void bench_actor_switch(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		do
+		{
+			bs.begin();
+			for (size_t i = 0; i < bs._batch; i++)
+			{
+				self->tick_yield();
+			}
+		} while (bs.end());
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+}
+
+/*!
+@brief generatorл(co_tick)
+*/
+static void bench_generator_yield(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	co_go(boost_strand::create(ios))[&](co_generator)
+	{
+		co_begin_context;
+		size_t i;
+		co_end_context(ctx);
+
+		co_begin;
+		do
+		{
+			bs.begin();
+			for (ctx.i = 0; ctx.i < bs._batch; ctx.i++)
+			{
+				co_tick;
+			}
+		} while (bs.end());
+		co_end;
+	};
+	ios.stop();
+}
+
+/*!
+@brief strandpostͶ+ִ
+*/
+static void bench_strand_post(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	size_t count = 0;
+	std::function<void()> round = [&]
+	{
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			strand->post([&] { count++; });
+		}
+		strand->post([&]
+		{
+			if (bs.end())
+			{
+				strand->post(round);
+			}
+		});
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief strandnext_tickͶ+ִ
+*/
+static void bench_strand_next_tick(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	size_t count = 0;
+	std::function<void()> round = [&]
+	{
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			strand->next_tick([&] { count++; });
+		}
+		strand->next_tick([&]
+		{
+			if (bs.end())
+			{
+				strand->post(round);
+			}
+		});
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief һstrand dispatch(ռúֱִ)
+*/
+static void bench_strand_dispatch(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	shared_strand target = boost_strand::create(ios);
+	size_t count = 0;
+	std::function<void()> round = [&]
+	{
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			target->dispatch([&] { count++; });
+		}
+		if (bs.end())
+		{
+			strand->post(round);
+		}
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief channelдchannelstrandУcrossStrandʱһstrand
+*/
+template <typename Chan>
+static void bench_chan_run(bench_sample& bs, bool crossStrand)
+{
+	io_engine ios;
+	ios.run();
+	std::shared_ptr<Chan> channel = Chan::make(boost_strand::create(ios), 16);
+	co_go(crossStrand ? boost_strand::create(ios) : channel->self_strand())[&, channel](co_generator)
+	{
+		co_begin_context;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		while (true)
+		{
+			co_chan_io(*channel) << 1;
+			if (co_last_state_is_closed)
+			{
+				break;
+			}
+		}
+		co_end;
+	};
+	co_go(channel->self_strand())[&, channel](co_generator)
+	{
+		co_begin_context;
+		size_t i;
+		int res;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		do
+		{
+			bs.begin();
+			for (ctx.i = 0; ctx.i < bs._batch; ctx.i++)
+			{
+				co_chan_io(*channel) >> ctx.res;
+			}
+		} while (bs.end());
+		co_chan_close(*channel);
+		co_end;
+	};
+	ios.stop();
+}
+
+static void bench_chan_same_strand(bench_sample& bs)
+{
+	bench_chan_run<co_channel<int>>(bs, false);
+}
+
+static void bench_chan_cross_strand(bench_sample& bs)
+{
+	bench_chan_run<co_channel<int>>(bs, true);
+}
+
+static void bench_mpmc_chan_cross_strand(bench_sample& bs)
+{
+	bench_chan_run<co_mpmc_channel<int>>(bs, true);
+}
+
+/*!
+@brief ͬstrandco_ring_channelдfastΪtrueʱaff_fast_push/aff_fast_pop·
+*/
+static void bench_ring_chan_run(bench_sample& bs, bool fast)
+{
+	io_engine ios;
+	ios.run();
+	std::shared_ptr<co_ring_channel<int>> channel = co_ring_channel<int>::make(boost_strand::create(ios), 16);
+	co_go(channel->self_strand())[&, channel](co_generator)
+	{
+		co_begin_context;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		while (true)
+		{
+			if (fast)
+			{
+				co_chan_aff_fast_push(*channel, 1);
+			}
+			else
+			{
+				co_chan_aff_push(*channel, 1);
+			}
+			if (co_last_state_is_closed)
+			{
+				break;
+			}
+		}
+		co_end;
+	};
+	co_go(channel->self_strand())[&, channel](co_generator)
+	{
+		co_begin_context;
+		size_t i;
+		int res;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		do
+		{
+			bs.begin();
+			for (ctx.i = 0; ctx.i < bs._batch; ctx.i++)
+			{
+				if (fast)
+				{
+					co_chan_aff_fast_pop(*channel, ctx.res);
+				}
+				else
+				{
+					co_chan_aff_pop(*channel, ctx.res);
+				}
+			}
+		} while (bs.end());
+		co_chan_close(*channel);
+		co_end;
+	};
+	ios.stop();
+}
+
+static void bench_ring_chan_same_strand(bench_sample& bs)
+{
+	bench_ring_chan_run(bs, false);
+}
+
+static void bench_ring_chan_fast_path(bench_sample& bs)
+{
+	bench_ring_chan_run(bs, true);
+}
+
+/*!
+@brief ϢãactorͶݣactor
+*/
+static void bench_msg_pump(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		bool done = false;
+		child_handle ch = self->create_child([&](my_actor* self)
+		{
+			msg_pump_handle<int> pp = self->connect_msg_pump<int>();
+			do
+			{
+				bs.begin();
+				for (size_t i = 0; i < bs._batch; i++)
+				{
+					self->pump_msg(pp);
+				}
+			} while (bs.end());
+			done = true;
+		});
+		self->child_run(ch);
+		{
+			//ÿͶ64óһΣϢ໺64
+			auto ntf = self->connect_msg_notifer_to<int>(ch, false, false, 64);
+			for (int i = 1; !done; i++)
+			{
+				ntf(i);
+				if (0 == i % 64)
+				{
+					self->tick_yield();
+				}
+			}
+		}
+		self->child_wait_quit(ch);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+}
+
+/*!
+@brief actor++˳
+*/
+static void bench_actor_create(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		do
+		{
+			bs.begin();
+			for (size_t i = 0; i < bs._batch; i++)
+			{
+				child_handle ch = self->create_child([](my_actor* self) {});
+				self->child_run(ch);
+				self->child_wait_quit(ch);
+			}
+		} while (bs.end());
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+}
+
+/*!
+@brief generator++˳
+*/
+static void bench_generator_create(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	size_t count = 0;
+	std::function<void()> round = [&]
+	{
+		count = 0;
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			co_go(strand)[&](co_generator)
+			{
+				co_no_context;
+
+				co_begin;
+				if (bs._batch == ++count && bs.end())
+				{
+					strand->post(round);
+				}
+				co_end;
+			};
+		}
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief ĵgeneratorĿԽһco_tick
+*/
+static void bench_generator_create_context(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	size_t count = 0;
+	std::function<void()> round = [&]
+	{
+		count = 0;
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			co_go(strand)[&](co_generator)
+			{
+				co_begin_context;
+				size_t step;
+				co_end_context(ctx);
+
+				co_begin;
+				ctx.step = 0;
+				co_tick;
+				if (bs._batch == ++count && bs.end())
+				{
+					strand->post(round);
+				}
+				co_end;
+			};
+		}
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief generator_poolĵgeneratorո
+*/
+static void bench_generator_pool_go(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	generator_pool pool(strand, bs._batch);
+	size_t count = 0;
+	std::function<void()> round = [&]
+	{
+		count = 0;
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			co_pool_go(pool)[&](co_generator)
+			{
+				co_begin_context;
+				size_t step;
+				co_end_context(ctx);
+
+				co_begin;
+				ctx.step = 0;
+				co_tick;
+				if (bs._batch == ++count && bs.end())
+				{
+					strand->post(round);
+				}
+				co_end;
+			};
+		}
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief co_callݹһgenerator(ջѹ/)
+*/
+static void bench_generator_call(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	co_go(ios)[&](co_generator)
+	{
+		static auto callee = [](co_generator, const size_t& i)
+		{
+			co_no_context;
+			co_begin;
+			co_end;
+		};
+		co_begin_context;
+		size_t i;
+		co_end_context(ctx);
+
+		co_begin;
+		do
+		{
+			bs.begin();
+			for (ctx.i = 0; ctx.i < bs._batch; ctx.i++)
+			{
+				co_call(callee, ctx.i);
+			}
+		} while (bs.end());
+		co_end;
+	};
+	ios.stop();
+}
+
+/*!
+@brief ʱ+ȡ
+*/
+static void bench_timer_arm_cancel(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	async_timer timer = strand->make_timer();
+	std::function<void()> round = [&]
+	{
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			timer->timeout(1000, [] {});
+			timer->cancel();
+		}
+		if (bs.end())
+		{
+			strand->post(round);
+		}
+	};
+	strand->post(round);
+	ios.stop();
+}
+
+/*!
+@brief actorȡactor_mutex
+*/
+static void bench_mutex_handoff(bench_sample& bs)
+{
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		actor_mutex mtx(self->self_strand());
+		bool done = false;
+		child_handle ch1 = self->create_child([&](my_actor* self)
+		{
+			do
+			{
+				bs.begin();
+				for (size_t i = 0; i < bs._batch; i++)
+				{
+					mtx.lock(self);
+					self->tick_yield();
+					mtx.unlock(self);
+				}
+			} while (bs.end());
+			done = true;
+		});
+		child_handle ch2 = self->create_child([&](my_actor* self)
+		{
+			while (!done)
+			{
+				mtx.lock(self);
+				self->tick_yield();
+				mtx.unlock(self);
+			}
+		});
+		self->child_run(ch1, ch2);
+		self->child_wait_quit(ch1, ch2);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+}
+
+/*!
+@brief UDPÿͻbatchݱmanyΪtrueʱreceive_manyգreceive
+*/
+static void bench_udp_receive_run(bench_sample& bs, bool many)
+{
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		udp_socket udp(self->self_io_service());
+		udp.open_bind_v4(0);
+		const udp_socket::remote_sender_endpoint ep = udp_socket::make_endpoint("127.0.0.1", udp.boost_socket().local_endpoint().port());
+		boost::asio::ip::udp::socket sender(self->self_io_service(), boost::asio::ip::udp::v4());
+		char buf[64][32];
+		udp_socket::datagram msgs[64];
+		for (size_t i = 0; i < 64; i++)
+		{
+			msgs[i].buff = buf[i];
+			msgs[i].length = sizeof(buf[i]);
+		}
+		do
+		{
+			bs.begin();
+			for (size_t i = 0; i < bs._batch; i++)
+			{
+				sender.send_to(boost::asio::buffer(buf[0], sizeof(buf[0])), ep);
+			}
+			for (size_t n = 0; n < bs._batch;)
+			{
+				if (many)
+				{
+					n += udp.receive_many(self, msgs, std::min(bs._batch - n, (size_t)64)).s;
+				}
+				else
+				{
+					udp.receive(self, buf[0], sizeof(buf[0]));
+					n++;
+				}
+			}
+		} while (bs.end());
+		udp.close();
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+}
+
+static void bench_udp_receive(bench_sample& bs)
+{
+	bench_udp_receive_run(bs, false);
+}
+
+static void bench_udp_receive_many(bench_sample& bs)
+{
+	bench_udp_receive_run(bs, true);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+/*!
+@brief io_engine߳첽trace_line¼д̼߳¼̨߳д/dev/null
+*/
+static void bench_trace_line_async(bench_sample& bs)
+{
+	if (!trace_async_start("/dev/null"))
+	{
+		bs.skip("trace_async_start failed");
+		return;
+	}
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	std::function<void()> round = [&]
+	{
+		bs.begin();
+		for (size_t i = 0; i < bs._batch; i++)
+		{
+			trace_line("bench trace line ", i, ", ", 3.14);
+		}
+		if (bs.end())
+		{
+			strand->post(round);
+		}
+	};
+	strand->post(round);
+	ios.stop();
+	trace_async_stop();
+}
+
+static const bench_case _benchCases[] =
+{
+	{ "actor_switch", 10000, bench_actor_switch },
+	{ "generator_yield", 10000, bench_generator_yield },
+	{ "strand_post", 10000, bench_strand_post },
+	{ "strand_next_tick", 10000, bench_strand_next_tick },
+	{ "strand_dispatch", 10000, bench_strand_dispatch },
+	{ "chan_same_strand", 10000, bench_chan_same_strand },
+	{ "chan_cross_strand", 10000, bench_chan_cross_strand },
+	{ "mpmc_chan_cross_strand", 10000, bench_mpmc_chan_cross_strand },
+	{ "ring_chan_same_strand", 10000, bench_ring_chan_same_strand },
+	{ "ring_chan_fast_path", 10000, bench_ring_chan_fast_path },
+	{ "msg_pump", 10000, bench_msg_pump },
+	{ "actor_create", 1000, bench_actor_create },
+	{ "generator_create", 10000, bench_generator_create },
+	{ "generator_create_context", 10000, bench_generator_create_context },
+	{ "generator_pool_go", 10000, bench_generator_pool_go },
+	{ "generator_call", 10000, bench_generator_call },
+	{ "timer_arm_cancel", 10000, bench_timer_arm_cancel },
+	{ "mutex_handoff", 10000, bench_mutex_handoff },
+	{ "udp_receive", 64, bench_udp_receive },
+	{ "udp_receive_many", 64, bench_udp_receive_many },
+	{ "trace_line_async", 1000, bench_trace_line_async },
+};
+
+/*!
+@brief ȷȡٷλsorted
+*/
+static double percentile(const std::vector<double>& sorted, double p)
+{
+	assert(!sorted.empty());
+	size_t rank = (size_t)(p * sorted.size() / 100.0 + 0.999999);
+	rank = rank ? rank - 1 : 0;
+	return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+static bench_result run_case(const bench_case& bc, size_t samples, size_t warmup)
+{
+	bench_sample bs(bc._batch, samples, warmup);
+	bc._func(bs);
+	bench_result res = {};
+	res._name = bc._name;
+	res._batch = bc._batch;
+	if (bs._times.empty())
+	{
+		res._skipReason = bs._skipReason ? bs._skipReason : "no samples";
+		fprintf(stderr, "%s skipped: %s\n", bc._name, res._skipReason);
+		return res;
+	}
+	std::vector<double> nsPerOp(bs._times.size());
+	double sum = 0;
+	for (size_t i = 0; i < bs._times.size(); i++)
+	{
+		nsPerOp[i] = (double)bs._times[i] / (double)bc._batch;
+		sum += nsPerOp[i];
+	}
+	std::sort(nsPerOp.begin(), nsPerOp.end());
+	res._samples = nsPerOp.size();
+	res._min = nsPerOp.front();
+	res._p50 = percentile(nsPerOp, 50);
+	res._p90 = percentile(nsPerOp, 90);
+	res._p99 = percentile(nsPerOp, 99);
+	res._max = nsPerOp.back();
+	res._mean = sum / nsPerOp.size();
+	return res;
+}
+
+static void print_csv(const std::vector<bench_result>& results)
+{
+	printf("name,batch,samples,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns,ops_per_sec\n");
+	for (const bench_result& ele : results)
+	{
+		if (ele._skipReason)
+		{//ֻ֣ͳ
+			printf("%s,%zu,0,,,,,,,\n", ele._name, ele._batch);
+			continue;
+		}
+		printf("%s,%zu,%zu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f\n", ele._name, ele._batch, ele._samples,
+			ele._min, ele._p50, ele._p90, ele._p99, ele._max, ele._mean, 1000000000.0 / ele._p50);
+	}
+}
+
+static void print_json(const std::vector<bench_result>& results)
+{
+	printf("{\n\t\"unit\": \"ns/op\",\n\t\"benchmarks\": [");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const bench_result& ele = results[i];
+		if (ele._skipReason)
+		{
+			printf("%s\n\t\t{ \"name\": \"%s\", \"batch\": %zu, \"samples\": 0, \"skipped\": \"%s\" }", i ? "," : "", ele._name, ele._batch, ele._skipReason);
+			continue;
+		}
+		printf("%s\n\t\t{ \"name\": \"%s\", \"batch\": %zu, \"samples\": %zu, \"min\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f, \"mean\": %.2f, \"ops_per_sec\": %.0f }",
+			i ? "," : "", ele._name, ele._batch, ele._samples, ele._min, ele._p50, ele._p90, ele._p99, ele._max, ele._mean, 1000000000.0 / ele._p50);
+	}
+	printf("\n\t]\n}\n");
+}
+
+static void print_usage(const char* exe)
+{
+	printf("usage: %s [--csv|--json] [--samples N] [--warmup N] [--list] [name ...]\n", exe);
+}
+
+int main(int argc, char *argv[])
+{
+	bool csv = false;
+	size_t samples = 100;
+	size_t warmup = 3;
+	std::vector<const char*> filters;
+	for (int i = 1; i < argc; i++)
+	{
+		if (0 == strcmp("--csv", argv[i]))
+		{
+			csv = true;
+		}
+		else if (0 == strcmp("--json", argv[i]))
+		{
+			csv = false;
+		}
+		else if (0 == strcmp("--samples", argv[i]) && i + 1 < argc)
+		{
+			samples = std::max(1, atoi(argv[++i]));
+		}
+		else if (0 == strcmp("--warmup", argv[i]) && i + 1 < argc)
+		{
+			warmup = std::max(0, atoi(argv[++i]));
+		}
+		else if (0 == strcmp("--list", argv[i]))
+		{
+			for (const bench_case& ele : _benchCases)
+			{
+				printf("%s\n", ele._name);
+			}
+			return 0;
+		}
+		else if ('-' == argv[i][0])
+		{
+			print_usage(argv[0]);
+			return 1;
+		}
+		else
+		{
+			filters.push_back(argv[i]);
+		}
+	}
+	init_my_actor();
+	enable_high_resolution();
+	std::vector<bench_result> results;
+	for (const bench_case& ele : _benchCases)
+	{
+		bool matched = filters.empty();
+		for (const char* filter : filters)
+		{
+			if (strstr(ele._name, filter))
+			{
+				matched = true;
+				break;
+			}
+		}
+		if (matched)
+		{
+			results.push_back(run_case(ele, samples, warmup));
+		}
+	}
+	csv ? print_csv(results) : print_json(results);
+	return 0;
+}
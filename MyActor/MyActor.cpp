@@ -1,6 +1,7 @@
 #include <iostream>
 #include "./actor/my_actor.h"
 #include "./actor/actor_socket.h"
+#include "./actor/buffered_stream.h"
 #include "./actor/async_timer.h"
 #include "./actor/msg_queue.h"
 #include "./actor/generator.h"
@@ -501,6 +502,70 @@ void pump_test()
 	trace_line("end pump_test");
 }
 
+void pump_msgs_test()
+{
+	trace_line("begin pump_msgs_test");
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		const int producerNum = 4;
+		const int msgNum = 100000;
+		child_handle ch = self->create_child([&](my_actor* self)
+		{
+			msg_pump_handle<int, int> pp = self->connect_msg_pump<int, int>();
+			std::vector<std::tuple<int, int>> msgs;
+			std::vector<int> lastVal(producerNum, -1);
+			size_t total = 0, wakeup = 0;
+			while (total < producerNum * msgNum)
+			{
+				msgs.clear();
+				total += self->pump_msgs(pp, msgs, 256);
+				wakeup++;
+				for (auto& msg : msgs)
+				{
+					assert(std::get<1>(msg) == lastVal[std::get<0>(msg)] + 1);
+					lastVal[std::get<0>(msg)] = std::get<1>(msg);
+				}
+			}
+			trace_comma(self->self_id(), "msgs", total, "wakeup", wakeup);
+		});
+		self->child_run(ch);
+		auto ntf = self->connect_msg_notifer_to<int, int>(ch, false, false, producerNum * msgNum);
+		long long tm = get_tick_us();
+		child_handle producers[producerNum];
+		for (int i = 0; i < producerNum; i++)
+		{
+			producers[i] = self->create_child(boost_strand::create(ios), [&, ntf, i](my_actor* self)
+			{
+				std::vector<std::tuple<int, int>> batch;
+				for (int j = 0; j < msgNum; j++)
+				{
+					batch.push_back(std::make_tuple(i, j));
+					if (64 == batch.size())
+					{
+						ntf.post_msgs(std::move(batch));
+						batch.clear();
+						self->yield();
+					}
+				}
+				ntf.post_msgs(batch.begin(), batch.end());
+			});
+			self->child_run(producers[i]);
+		}
+		self->child_wait_quit(ch);
+		for (int i = 0; i < producerNum; i++)
+		{
+			self->child_wait_quit(producers[i]);
+		}
+		trace_comma(self->self_id(), "time", (get_tick_us() - tm) / 1000, "ms");
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end pump_msgs_test");
+}
+
 void msg_test()
 {
 	trace_line("begin msg_test");
@@ -771,10 +836,261 @@ void udp_test()
 	trace_line("end udp_test");
 }
 
-void perfor_test()
+void udp_many_test()
+{
+	trace_line("begin udp_many_test");
+	io_engine ios;
+	ios.run();
+	shared_strand strand = boost_strand::create(ios);
+	co_go(strand)[](co_generator)
+	{
+		co_begin_context;
+		int n;
+		char buf[8][64];
+		udp_socket::datagram msgs[8];
+		udp_socket::result res;
+		bool overtime;
+		stack_obj<udp_socket> udp;
+		co_use_timer;
+		co_end_context_init(ctx, (co_self), n(0), overtime(false));
+
+		co_begin;
+		ctx.udp.create(co_strand->get_io_service());
+		ctx.udp->open_bind_v4(1237);
+		for (int i = 0; i < 8; i++)
+		{
+			ctx.msgs[i].buff = ctx.buf[i];
+			ctx.msgs[i].length = sizeof(ctx.buf[i]) - 1;
+		}
+		while (ctx.n < 8)
+		{
+			//һιȡѵݱ
+			co_timed_await(1500, { ctx.overtime = true; ctx.udp->close(); }) ctx.udp->async_receive_many(ctx.msgs, 8, co_async_result(ctx.res));
+			if (!ctx.res.ok || ctx.overtime)
+			{
+				break;
+			}
+			for (size_t i = 0; i < ctx.res.s; i++)
+			{
+				ctx.buf[i][ctx.msgs[i].s] = 0;
+				trace_comma("co_udp", ctx.res.s, ctx.buf[i]);
+			}
+			ctx.n += (int)ctx.res.s;
+		}
+		ctx.udp->close();
+		co_end;
+	};
+	actor_handle ah = my_actor::create(strand, [](my_actor* self)
+	{
+		self->sleep(100);
+		udp_socket udp(self->self_io_service());
+		udp.open_v4();
+		char buf[8][64];
+		udp_socket::datagram msgs[8];
+		for (int i = 0; i < 8; i++)
+		{
+			msgs[i].buff = buf[i];
+			msgs[i].length = snprintf(buf[i], sizeof(buf[i]), "udp many %d", i);
+			msgs[i].remoteEndpoint = udp_socket::make_endpoint("127.0.0.1", 1237);
+		}
+		udp_socket::result res = udp.send_many(self, msgs, 8);
+		trace_comma(self->self_id(), "send_many", res.ok, res.s);
+		udp.close();
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end udp_many_test");
+}
+
+void buffer_chain_test()
+{
+	trace_line("begin buffer_chain_test");
+	io_engine ios;
+	ios.run();
+	shared_buffer_pool pool = buffer_pool::create(256);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		child_handle srv = self->create_child([&](my_actor* self)
+		{
+			tcp_acceptor acc(self->self_io_service());
+			if (!acc.open("127.0.0.1", 1236))
+			{
+				trace_line("server port conflict");
+				return;
+			}
+			tcp_socket sck(self->self_io_service());
+			bool overtime = false;
+			if (acc.timed_accept(self, 1500, overtime, sck))
+			{
+				acc.close();
+				while (true)
+				{
+					//ͷɢƬ
+					buffer_chain chain;
+					chain.push_back(pool->alloc(sizeof(int)));
+					chain.push_back(pool->alloc(5));
+					tcp_socket::result res = sck.timed_read(self, 2000, overtime, chain);
+					if (!res.ok)
+					{
+						break;
+					}
+					trace_comma(self->self_id(), "received", *(int*)chain[0].data(), std::string(chain[1].data(), chain[1].size()));
+				}
+			}
+			sck.close();
+		});
+		child_handle cli = self->create_child([&](my_actor* self)
+		{
+			tcp_socket sck(self->self_io_service());
+			if (sck.connect(self, "127.0.0.1", 1236))
+			{
+				//֡ͬһƬһwritevͷ
+				buffer_slice body = pool->alloc_copy("hello", 5);
+				for (int i = 0; i < 3; i++)
+				{
+					buffer_chain chain;
+					chain.push_back(pool->alloc_copy(&i, sizeof(i)));
+					chain.push_back(body);
+					if (!sck.write(self, chain).ok)
+					{
+						break;
+					}
+				}
+			}
+			sck.close();
+		});
+		self->child_run(srv);
+		self->sleep(100);
+		self->child_run(cli);
+		self->child_wait_quit(srv, cli);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end buffer_chain_test");
+}
+
+void buffered_stream_test()
 {
-	trace_line("begin perfor_test");
+	trace_line("begin buffered_stream_test");
 	io_engine ios;
+	ios.run();
+	shared_buffer_pool pool = buffer_pool::create(256);
+	shared_strand strand = boost_strand::create(ios);
+	actor_handle ah = my_actor::create(strand, [&](my_actor* self)
+	{
+		tcp_acceptor acc(self->self_io_service());
+		if (!acc.open("127.0.0.1", 1238))
+		{
+			trace_line("server port conflict");
+			return;
+		}
+		tcp_socket sck(self->self_io_service());
+		bool overtime = false;
+		if (acc.timed_accept(self, 1500, overtime, sck))
+		{
+			acc.close();
+			buffered_reader reader(sck, pool);
+			std::string line;
+			while (true)
+			{
+				//ͷΪĳȣĽ
+				tcp_socket::result res = reader.timed_read_until(self, 1500, overtime, '\n');
+				if (!res.ok)
+				{
+					break;
+				}
+				line.assign(reader.data(), res.s - 1);
+				reader.consume(res.s);
+				char body[64];
+				size_t l = atoi(line.c_str());
+				if (l >= sizeof(body) || !reader.read_exact(self, body, l).ok)
+				{
+					break;
+				}
+				trace_comma(self->self_id(), "received", line, std::string(body, l));
+			}
+		}
+		sck.close();
+	});
+	co_go(strand)[&](co_generator)
+	{
+		co_begin_context;
+		int i;
+		char buf[64];
+		tcp_socket::result res;
+		stack_obj<tcp_socket> sck;
+		stack_obj<buffered_writer> writer;
+		co_end_context_init(ctx, (co_self), i(0));
+
+		co_begin;
+		co_sleep(100);
+		ctx.sck.create(co_strand->get_io_service());
+		co_await ctx.sck->async_connect("127.0.0.1", 1238, co_async_result(ctx.res));
+		if (ctx.res.ok)
+		{
+			ctx.writer.create(co_strand, ctx.sck.get(), pool);
+			for (ctx.i = 0; ctx.i < 3; ctx.i++)
+			{
+				//СдóstrandϲΪһη
+				co_await {
+					int l = snprintf(ctx.buf, sizeof(ctx.buf), "%d\n", 6 + ctx.i);
+					ctx.writer->async_write(ctx.buf, l, co_async_result(ctx.res));
+				}
+				co_await ctx.writer->async_write("buffer", 6, co_async_result(ctx.res));
+				co_await ctx.writer->async_write("!!!", ctx.i, co_async_result(ctx.res));
+			}
+			co_await ctx.writer->async_flush(co_async_result(ctx.res));
+			trace_comma("co_writer", "flush", ctx.res.ok);
+			ctx.writer.destroy();
+			co_sleep(100);
+		}
+		ctx.sck->close();
+		ctx.sck.destroy();
+		co_end;
+	};
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end buffered_stream_test");
+}
+
+void trace_async_test()
+{
+	trace_line("begin trace_async_test");
+	trace_async_start();
+	io_engine ios;
+	ios.run(2);
+	std::vector<actor_handle> actors;
+	for (int i = 0; i < 4; i++)
+	{
+		actors.push_back(my_actor::create(boost_strand::create(ios), [i](my_actor* self)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				//ֻд뵱ǰio_engine̵߳ļ¼ɺ̨̰߳źϲд
+				info_trace_comma("async", i, j);
+				self->yield();
+			}
+		}));
+		actors.back()->run();
+	}
+	trace_line("from main thread");
+	for (actor_handle& ele : actors)
+	{
+		ele->outside_wait_quit();
+	}
+	ios.stop();
+	trace_async_flush();
+	trace_async_stop();
+	trace_line("end trace_async_test");
+}
+
+void perfor_test(io_engine::schedule_mode mode = io_engine::shared_queue)
+{
+	trace_line("begin perfor_test", io_engine::work_stealing == mode ? " (work_stealing)" : " (shared_queue)");
+	io_engine ios(mode);
 	ios.run(run_thread::cpu_thread_number());
 	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
 	{
@@ -816,6 +1132,175 @@ void perfor_test()
 	trace_line("end perfor_test");
 }
 
+#ifdef ENABLE_SCHEDULER_STATS
+void scheduler_stats_test()
+{
+	trace_line("begin scheduler_stats_test");
+	io_engine ios;
+	ios.run(2);
+	std::vector<shared_strand> strands = boost_strand::create_multi(4, ios);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		std::list<child_handle> childList;
+		for (size_t i = 0; i < strands.size(); i++)
+		{
+			childList.push_front(self->create_child(strands[i], [](my_actor* self)
+			{
+				while (true)
+				{
+					self->tick_yield();
+				}
+			}));
+		}
+		self->children_run(childList);
+		for (int i = 0; i < 3; i++)
+		{
+			self->sleep(200);
+			for (auto& ele : ios.stats())
+			{
+				trace_line("thread ", ele.index, ", tasks=", ele.tasks, ", handlers=", ele.handlers, ", busy=", ele.busyTime, "us, idle=", ele.idleTime, "us");
+			}
+			for (size_t j = 0; j < strands.size(); j++)
+			{
+				boost_strand::stats_info st = strands[j]->stats();
+				trace_line("strand ", j, ", post=", st.posted, ", dispatch=", st.dispatched, ", tick=", st.ticked, ", invoke=", st.invoked, ", peak=", st.peakDepth, ", run=", st.runTime, "us");
+			}
+		}
+		self->children_force_quit(childList);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	strands.clear();
+	ios.stop();
+	trace_line("end scheduler_stats_test");
+}
+#endif
+
+#ifdef ENABLE_EVENT_TRACE
+void event_trace_test()
+{
+	trace_line("begin event_trace_test");
+	event_trace::start();
+	io_engine ios;
+	ios.run(2);
+	shared_strand strand = boost_strand::create(ios);
+	co_channel<int> channel(strand, 1);
+	actor_handle ah = my_actor::create(strand, [](my_actor* self)
+	{
+		actor_mutex mtx(self->self_strand());
+		child_handle ch1 = self->create_child([&](my_actor* self)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				mtx.lock(self);
+				self->sleep(10);
+				mtx.unlock(self);
+			}
+		});
+		child_handle ch2 = self->create_child([&](my_actor* self)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				mtx.lock(self);
+				self->sleep(10);
+				mtx.unlock(self);
+			}
+		});
+		self->child_run(ch1, ch2);
+		self->child_wait_quit(ch1, ch2);
+	});
+	co_go(strand)[&](co_generator)
+	{
+		co_begin_context;
+		int i;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		for (ctx.i = 0; ctx.i < 5; ctx.i++)
+		{
+			co_chan_io(channel) << ctx.i;
+		}
+		co_end;
+	};
+	co_go(strand)[&](co_generator)
+	{
+		co_begin_context;
+		int i;
+		int id;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		for (ctx.i = 0; ctx.i < 5; ctx.i++)
+		{
+			co_chan_io(channel) >> ctx.id;
+			co_sleep(5);
+		}
+		co_end;
+	};
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	event_trace::stop();
+	//chrome://tracingui.perfetto.dev
+	trace_line("dump event_trace.json ", event_trace::dump("event_trace.json"));
+	trace_line("end event_trace_test");
+}
+#endif
+
+void affinity_test()
+{
+	trace_line("begin affinity_test");
+	io_engine ios(io_engine::work_stealing);
+	std::vector<int> cpuList = io_engine::parseCpuList("0-1,3");
+	ios.run(2, cpuList);
+	trace_line("cpu list size:", ios.cpuList().size());
+	trace_line("reversed/negative cpu list size:", io_engine::parseCpuList("3-1").size(), " ", io_engine::parseCpuList("-1,2").size());
+	//ͬһ߳ϵactorstrandִ
+	shared_strand strand1 = boost_strand::create(ios, 1);
+	shared_strand strand2 = boost_strand::create(ios, 1);
+	int count = 0;
+	actor_handle ah = my_actor::create(strand1, [&](my_actor* self)
+	{
+		for (int i = 0; i < 10000; i++)
+		{
+			self->send(strand2, [&]
+			{
+				count++;
+			});
+		}
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	trace_line("send count:", count);
+	ios.stop();
+	trace_line("end affinity_test");
+}
+
+void idle_policy_test()
+{
+	trace_line("begin idle_policy_test");
+	io_engine ios;
+	ios.setIdlePolicy(1500, 500);
+	ios.run(2);
+	shared_strand strand = boost_strand::create(ios);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		for (int i = 0; i < 100; i++)
+		{
+			self->send(strand, [] {});
+			self->sleep(1);
+		}
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	io_engine::idle_stats st = ios.idleStats();
+	trace_line("spin wake:", st.spinWake, ", yield wake:", st.yieldWake, ", parked:", st.parked);
+	ios.stop();
+	trace_line("end idle_policy_test");
+}
+
 void async_timer_test()
 {
 	trace_line("begin async_timer_test");
@@ -871,6 +1356,80 @@ void async_timer_test()
 	trace_line("end async_timer_test");
 }
 
+void timer_perfor_test()
+{
+	trace_line("begin timer_perfor_test");
+	const size_t num = 1000000;
+	std::vector<long long> randDeadlines(num);
+	std::vector<long long> seqDeadlines(num);
+	std::vector<size_t> order(num);
+	unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+	auto nextRand = [&seed]()->size_t
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (size_t)(seed >> 33);
+	};
+	long long ct = get_tick_us();
+	for (size_t i = 0; i < num; i++)
+	{
+		randDeadlines[i] = ct + 1000 + (long long)(nextRand() % 60000) * 1000;
+		seqDeadlines[i] = ct + 30000000 + (long long)i;
+		order[i] = i;
+	}
+	for (size_t i = num - 1; i > 0; i--)
+	{
+		std::swap(order[i], order[nextRand() % (i + 1)]);
+	}
+	for (int k = 0; k < 2; k++)
+	{
+		const std::vector<long long>& deadlines = 0 == k ? randDeadlines : seqDeadlines;
+		{
+			typedef msg_multimap<long long, size_t> timer_map;
+			timer_map timerMap(num);
+			std::vector<timer_map::iterator> nodes(num);
+			long long extMaxTick = 0;
+			long long tk = get_tick_us();
+			for (size_t i = 0; i < num; i++)
+			{
+				if (deadlines[i] >= extMaxTick)
+				{
+					extMaxTick = deadlines[i];
+					nodes[i] = timerMap.insert(timerMap.end(), std::make_pair(deadlines[i], i));
+				}
+				else
+				{
+					nodes[i] = timerMap.insert(std::make_pair(deadlines[i], i));
+				}
+			}
+			long long armTk = get_tick_us();
+			for (size_t i = 0; i < num; i++)
+			{
+				timerMap.erase(nodes[order[i]]);
+			}
+			long long cancelTk = get_tick_us();
+			trace_line(0 == k ? "random" : "sequential", " msg_multimap timers=", num, ", arm=", armTk - tk, "us, cancel=", cancelTk - armTk, "us");
+		}
+		{
+			typedef msg_timer_wheel<size_t> timer_wheel;
+			timer_wheel timerWheel(num);
+			std::vector<timer_wheel::iterator> nodes(num);
+			long long tk = get_tick_us();
+			for (size_t i = 0; i < num; i++)
+			{
+				nodes[i] = timerWheel.insert(deadlines[i], ct, i);
+			}
+			long long armTk = get_tick_us();
+			for (size_t i = 0; i < num; i++)
+			{
+				timerWheel.erase(nodes[order[i]]);
+			}
+			long long cancelTk = get_tick_us();
+			trace_line(0 == k ? "random" : "sequential", " msg_timer_wheel timers=", num, ", arm=", armTk - tk, "us, cancel=", cancelTk - armTk, "us");
+		}
+	}
+	trace_line("end timer_perfor_test");
+}
+
 void create_child_test()
 {
 	trace_line("begin create_child_test");
@@ -971,10 +1530,46 @@ void auto_stack_test()
 		ah->outside_wait_quit();
 		trace_line("stack size:", ah->stack_size(), ", using size:", ah->using_stack_size());
 	}
+	std::stringstream stackTable;
+	my_actor::export_auto_stack(stackTable);
+	trace("auto stack table:\n", stackTable.str());
+	//ԤcontextҪfiberio_engine߳е
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		trace_line("import auto stack:", my_actor::import_auto_stack(stackTable, 2));
+	});
+	ah->run();
+	ah->outside_wait_quit();
 	ios.stop();
 	trace_line("end auto_stack_test");
 }
 
+#ifdef ENABLE_GROWABLE_STACK
+size_t stack_recursion(int depth)
+{
+	volatile char buff[1024];
+	buff[0] = 1;
+	return depth ? stack_recursion(depth - 1) + buff[0] : 0;
+}
+
+void growable_stack_test()
+{
+	trace_line("begin growable_stack_test");
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [](my_actor* self)
+	{
+		//4KջϵݹʹԼ256Kջռ
+		trace_line("recursion result:", stack_recursion(256));
+	}, 4 * 1024);
+	ah->run();
+	ah->outside_wait_quit();
+	trace_line("stack size:", ah->stack_size());
+	ios.stop();
+	trace_line("end growable_stack_test");
+}
+#endif
+
 void co_perfor_test()
 {
 	trace_line("begin co_perfor_test");
@@ -1021,6 +1616,149 @@ void co_perfor_test()
 	trace_line("end co_perfor_test");
 }
 
+void co_create_perfor_test()
+{
+	trace_line("begin co_create_perfor_test");
+	io_engine ios;
+	ios.run(run_thread::cpu_thread_number());
+	std::vector<size_t> count(ios.threadNumber());
+	std::vector<shared_strand> strands = boost_strand::create_multi(ios.threadNumber(), ios);
+	std::vector<std::function<void()>> rounds(ios.threadNumber());
+	std::atomic<bool> exitSign(false);
+	std::atomic<size_t> exitCount(0);
+	size_t num = 1000;
+	for (size_t i = 0; i < ios.threadNumber(); i++)
+	{
+		//ÿִnumĵgeneratorȫʼһ
+		rounds[i] = [&, i]
+		{
+			std::shared_ptr<size_t> rest = std::make_shared<size_t>(num);
+			for (size_t j = 0; j < num; j++)
+			{
+				co_go(strands[i])[&, i, j, rest](co_generator)
+				{
+					co_begin_context;
+					size_t id;
+					int step;
+					co_end_context(ctx);
+
+					co_begin;
+					ctx.id = j;
+					for (ctx.step = 0; ctx.step < 2; ctx.step++)
+					{
+						co_tick;
+					}
+					++count[i];
+					if (0 == --*rest)
+					{
+						if (!exitSign)
+						{
+							strands[i]->post(rounds[i]);
+						}
+						else
+						{
+							exitCount++;
+						}
+					}
+					co_end;
+				};
+			}
+		};
+		strands[i]->post(rounds[i]);
+	}
+	long long tk = get_tick_us();
+	run_thread::sleep(3000);
+	exitSign = true;
+	size_t ct = 0;
+	for (size_t i = 0; i < count.size(); i++)
+	{
+		ct += count[i];
+	}
+	double f = (double)ct * 1000000 / (get_tick_us() - tk);
+	while (exitCount != strands.size())
+	{
+		run_thread::sleep(1);
+	}
+	ios.stop();
+	trace_line("inline context space=", GENERATOR_CONTEXT_SPACE, ", ", "create/destroy frequency=", (int)f);
+	trace_line("end co_create_perfor_test");
+}
+
+void co_pool_perfor_test()
+{
+	trace_line("begin co_pool_perfor_test");
+	io_engine ios;
+	ios.run(run_thread::cpu_thread_number());
+	std::vector<size_t> count(ios.threadNumber());
+	std::vector<shared_strand> strands = boost_strand::create_multi(ios.threadNumber(), ios);
+	std::vector<std::unique_ptr<generator_pool>> pools(ios.threadNumber());
+	std::vector<std::function<void()>> rounds(ios.threadNumber());
+	std::atomic<bool> exitSign(false);
+	std::atomic<size_t> exitCount(0);
+	size_t num = 1000;
+	for (size_t i = 0; i < ios.threadNumber(); i++)
+	{
+		pools[i].reset(new generator_pool(strands[i], num));
+		//ÿִӳnumgeneratorȫʼһ֣generatorյи
+		rounds[i] = [&, i]
+		{
+			size_t* const rest = new size_t(num);
+			for (size_t j = 0; j < num; j++)
+			{
+				co_pool_go(*pools[i])[&, i, rest](co_generator)
+				{
+					co_begin_context;
+					int step;
+					co_end_context(ctx);
+
+					co_begin;
+					for (ctx.step = 0; ctx.step < 2; ctx.step++)
+					{
+						co_tick;
+					}
+					++count[i];
+					if (0 == --*rest)
+					{
+						delete rest;
+						if (!exitSign)
+						{
+							strands[i]->post(rounds[i]);
+						}
+						else
+						{
+							exitCount++;
+						}
+					}
+					co_end;
+				};
+			}
+		};
+		strands[i]->post(rounds[i]);
+	}
+	long long tk = get_tick_us();
+	run_thread::sleep(3000);
+	exitSign = true;
+	size_t ct = 0;
+	for (size_t i = 0; i < count.size(); i++)
+	{
+		ct += count[i];
+	}
+	double f = (double)ct * 1000000 / (get_tick_us() - tk);
+	while (exitCount != strands.size())
+	{
+		run_thread::sleep(1);
+	}
+	ios.stop();
+	size_t idle = 0;
+	for (size_t i = 0; i < pools.size(); i++)
+	{
+		idle += pools[i]->size();
+	}
+	pools.clear();
+	trace_line("idle generator number=", idle, ", ", "pooled go frequency=", (int)f);
+	trace_line("end co_pool_perfor_test");
+}
+
 void co_convar_test()
 {
 	trace_line("begin co_convar_test");
@@ -1223,55 +1961,159 @@ void co_select_msg_test()
 	trace_line("end co_select_msg_test");
 }
 
-void co_chan_perfor_test()
+template <typename Chan>
+void co_chan_perfor_run(io_engine& ios, int threads, int msgNum, const char* name)
 {
-	trace_line("begin co_chan_perfor_test");
-	io_engine ios;
-	const int msgNum = 10000000;
-	for (int i = 1; i <= 4; i++)
+	ios.run(threads);
+	std::atomic<int> msgCount(0);
+	std::atomic<int> recCount(0);
+	long long beginTick = get_tick_ms();
+	for (int j = 1; j <= threads; j++)
 	{
-		ios.run(i);
-		trace_line(i, " threads, msg number", msgNum);
-		std::atomic<int> msgCount(0);
-		std::atomic<int> recCount(0);
-		long long beginTick = get_tick_ms();
-		for (int j = 1; j <= i; j++)
+		std::shared_ptr<Chan> channel = Chan::make(boost_strand::create(ios), 3);
+		for (int k = 0; k < 100; k++)
 		{
-			std::shared_ptr<co_channel<int>> channel = std::make_shared<co_channel<int>>(boost_strand::create(ios), 3);
-			for (int k = 0; k < 100; k++)
+			co_go(channel->self_strand())[&, channel](co_generator)
 			{
-				co_go(channel->self_strand())[&, channel](co_generator)
+				co_begin_context;
+				co_use_state;
+				co_end_context(ctx);
+
+				co_begin;
+				while (++msgCount <= msgNum)
 				{
-					co_begin_context;
-					co_use_state;
-					co_end_context(ctx);
+					co_chan_aff_io(*channel) << msgCount;
+				}
+				co_end;
+			};
+			co_go(channel->self_strand())[&, channel](co_generator)
+			{
+				co_begin_context;
+				int res;
+				co_use_state;
+				co_end_context(ctx);
 
-					co_begin;
-					while (++msgCount <= msgNum)
-					{
-						co_chan_aff_io(*channel) << msgCount;
-					}
-					co_end;
-				};
-				co_go(channel->self_strand())[&, channel](co_generator)
+				co_begin;
+				while (++recCount <= msgNum)
 				{
-					co_begin_context;
-					int res;
-					co_use_state;
-					co_end_context(ctx);
+					co_chan_aff_io(*channel) >> ctx.res;
+				}
+				co_end;
+			};
+		}
+	}
+	ios.stop();
+	long long time = get_tick_ms() - beginTick;
+	trace_line(name, " time ", time, ", perfor ", (size_t)((double)msgNum * 1000.0 / (double)time), "/s");
+}
 
-					co_begin;
-					while (++recCount <= msgNum)
-					{
-						co_chan_aff_io(*channel) >> ctx.res;
-					}
-					co_end;
-				};
-			}
+template <typename Chan>
+void co_chan_fast_perfor_run(io_engine& ios, int threads, int msgNum, const char* name)
+{
+	ios.run(threads);
+	std::atomic<int> msgCount(0);
+	std::atomic<int> recCount(0);
+	long long beginTick = get_tick_ms();
+	for (int j = 1; j <= threads; j++)
+	{
+		std::shared_ptr<Chan> channel = Chan::make(boost_strand::create(ios), 3);
+		for (int k = 0; k < 100; k++)
+		{
+			co_go(channel->self_strand())[&, channel](co_generator)
+			{
+				co_begin_context;
+				co_use_state;
+				co_end_context(ctx);
+
+				co_begin;
+				while (++msgCount <= msgNum)
+				{
+					co_chan_aff_fast_push(*channel, msgCount);
+				}
+				co_end;
+			};
+			co_go(channel->self_strand())[&, channel](co_generator)
+			{
+				co_begin_context;
+				int res;
+				co_use_state;
+				co_end_context(ctx);
+
+				co_begin;
+				while (++recCount <= msgNum)
+				{
+					co_chan_aff_fast_pop(*channel, ctx.res);
+				}
+				co_end;
+			};
 		}
-		ios.stop();
-		long long time = get_tick_ms() - beginTick;
-		trace_line("time ", time, ", perfor ", (size_t)((double)msgNum * 1000.0 / (double)time), "/s");
+	}
+	ios.stop();
+	long long time = get_tick_ms() - beginTick;
+	trace_line(name, " fast path time ", time, ", perfor ", (size_t)((double)msgNum * 1000.0 / (double)time), "/s");
+}
+
+template <typename Chan>
+void co_chan_cross_perfor_run(io_engine& ios, int threads, int msgNum, const char* name)
+{
+	ios.run(threads);
+	std::atomic<int> msgCount(0);
+	std::atomic<int> recCount(0);
+	long long beginTick = get_tick_ms();
+	for (int j = 1; j <= threads; j++)
+	{
+		std::shared_ptr<Chan> channel = Chan::make(boost_strand::create(ios), 64);
+		shared_strand pushStrand = boost_strand::create(ios);
+		for (int k = 0; k < 10; k++)
+		{
+			co_go(pushStrand)[&, channel](co_generator)
+			{
+				co_begin_context;
+				co_use_state;
+				co_end_context(ctx);
+
+				co_begin;
+				while (++msgCount <= msgNum)
+				{
+					co_chan_io(*channel) << msgCount;
+				}
+				co_end;
+			};
+			co_go(channel->self_strand())[&, channel](co_generator)
+			{
+				co_begin_context;
+				int res;
+				co_use_state;
+				co_end_context(ctx);
+
+				co_begin;
+				while (++recCount <= msgNum)
+				{
+					co_chan_io(*channel) >> ctx.res;
+				}
+				co_end;
+			};
+		}
+	}
+	ios.stop();
+	long long time = get_tick_ms() - beginTick;
+	trace_line(name, " cross strand time ", time, ", perfor ", (size_t)((double)msgNum * 1000.0 / (double)time), "/s");
+}
+
+void co_chan_perfor_test(io_engine::schedule_mode mode = io_engine::shared_queue)
+{
+	trace_line("begin co_chan_perfor_test", io_engine::work_stealing == mode ? " (work_stealing)" : " (shared_queue)");
+	io_engine ios(mode);
+	const int msgNum = 10000000;
+	const int maxThreads = std::max(4, (int)run_thread::cpu_thread_number());
+	for (int i = 1; i <= maxThreads; i = i < 4 ? i + 1 : 2 * i)
+	{
+		trace_line(i, " threads, msg number", msgNum);
+		co_chan_perfor_run<co_channel<int>>(ios, i, msgNum, "co_channel");
+		co_chan_perfor_run<co_ring_channel<int>>(ios, i, msgNum, "co_ring_channel");
+		co_chan_fast_perfor_run<co_ring_channel<int>>(ios, i, msgNum, "co_ring_channel");
+		co_chan_cross_perfor_run<co_channel<int>>(ios, i, msgNum / 10, "co_channel");
+		co_chan_cross_perfor_run<co_mpmc_channel<int>>(ios, i, msgNum / 10, "co_mpmc_channel");
 	}
 	trace_line("end co_chan_perfor_test");
 }
@@ -1413,6 +2255,8 @@ int main(int argc, char *argv[])
 #ifdef NDEBUG
 	co_chan_perfor_test();
 	trace("\n");
+	co_chan_perfor_test(io_engine::work_stealing);
+	trace("\n");
 #endif
 	co_select_msg_test();
 	trace("\n");
@@ -1423,13 +2267,31 @@ int main(int argc, char *argv[])
 #ifdef NDEBUG
 	co_perfor_test();
 	trace("\n");
+	co_create_perfor_test();
+	trace("\n");
+	co_pool_perfor_test();
+	trace("\n");
+	timer_perfor_test();
+	trace("\n");
 #endif
 	auto_stack_test();
 	trace("\n");
+#ifdef ENABLE_GROWABLE_STACK
+	growable_stack_test();
+	trace("\n");
+#endif
 	suspend_test();
 	trace("\n");
 	create_child_test();
 	trace("\n");
+#ifdef ENABLE_EVENT_TRACE
+	event_trace_test();
+	trace("\n");
+#endif
+	affinity_test();
+	trace("\n");
+	idle_policy_test();
+	trace("\n");
 	async_timer_test();
 	trace("\n");
 	trig_test();
@@ -1438,6 +2300,12 @@ int main(int argc, char *argv[])
 	trace("\n");
 	pump_test();
 	trace("\n");
+	pump_msgs_test();
+	trace("\n");
+#ifdef ENABLE_SCHEDULER_STATS
+	scheduler_stats_test();
+	trace("\n");
+#endif
 	agent_test();
 	trace("\n");
 	mutex_test();
@@ -1454,9 +2322,19 @@ int main(int argc, char *argv[])
 	trace("\n");
 	udp_test();
 	trace("\n");
+	udp_many_test();
+	trace("\n");
+	buffer_chain_test();
+	trace("\n");
+	buffered_stream_test();
+	trace("\n");
+	trace_async_test();
+	trace("\n");
 	wait_multi_msg();
 	trace("\n");
 // 	perfor_test();
+// 	trace("\n");
+// 	perfor_test(io_engine::work_stealing);
 // 	trace("\n");
 	trace_line("end");
 	getchar();
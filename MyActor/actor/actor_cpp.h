@@ -16,6 +16,9 @@ DISABLE_BOOST_TIMER 
 ENABLE_GLOBAL_TIMER ȫֶʱ(DISABLE_BOOST_TIMERʹ)
 ENABLE_TLS_CHECK_SELF TLS⵱ǰĸActor
 ENABLE_ASIO_HANDLER_ALLOCATE_EX asio handlerչ
+ENABLE_STACK_ARENA Linux´Ӵзactorջ
+ENABLE_GROWABLE_STACK Linuxactorջչ(ENABLE_DUMP_STACK)
+ENABLE_EVENT_TRACE actor/generator/strand¼Ķ׷٣Chrome trace JSON
 
 */
 
@@ -25,8 +28,11 @@ ENABLE_ASIO_HANDLER_ALLOCATE_EX 
 #include "async_timer.cpp"
 #include "bind_node_run.cpp"
 #include "bind_qt_run.cpp"
+#include "buffer_chain.cpp"
+#include "buffered_stream.cpp"
 #include "context_pool.cpp"
 #include "context_yield.cpp"
+#include "event_trace.cpp"
 #include "generator.cpp"
 #include "io_engine.cpp"
 #include "my_actor.cpp"
@@ -35,6 +41,7 @@ ENABLE_ASIO_HANDLER_ALLOCATE_EX 
 #include "scattered.cpp"
 #include "shared_strand.cpp"
 #include "strand_ex.cpp"
+#include "trace.cpp"
 #include "trace_stack.cpp"
 #include "uv_strand.cpp"
 #include "waitable_timer.cpp"
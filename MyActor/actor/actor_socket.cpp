@@ -1,4 +1,12 @@
 #include "actor_socket.h"
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
+//recvmmsg/sendmmsgദݱ
+#ifndef UDP_MMSG_BATCH
+#define UDP_MMSG_BATCH 32
+#endif
 
 tcp_socket::tcp_socket(boost::asio::io_service& ios)
 :_socket(ios) {}
@@ -173,6 +181,98 @@ tcp_socket::result tcp_socket::timed_write_some(my_actor* host, int ms, bool& ov
 	if (overtime) res.ok = false;
 	return res;
 }
+
+tcp_socket::result tcp_socket::read(my_actor* host, const buffer_chain& chain)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_read(chain, std::move(h));
+	});
+}
+
+tcp_socket::result tcp_socket::read_some(my_actor* host, const buffer_chain& chain)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_read_some(chain, std::move(h));
+	});
+}
+
+tcp_socket::result tcp_socket::write(my_actor* host, const buffer_chain& chain)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_write(chain, std::move(h));
+	});
+}
+
+tcp_socket::result tcp_socket::write_some(my_actor* host, const buffer_chain& chain)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_write_some(chain, std::move(h));
+	});
+}
+
+tcp_socket::result tcp_socket::timed_read(my_actor* host, int ms, bool& overtime, const buffer_chain& chain)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_read(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
+
+tcp_socket::result tcp_socket::timed_read_some(my_actor* host, int ms, bool& overtime, const buffer_chain& chain)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_read_some(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
+
+tcp_socket::result tcp_socket::timed_write(my_actor* host, int ms, bool& overtime, const buffer_chain& chain)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_write(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
+
+tcp_socket::result tcp_socket::timed_write_some(my_actor* host, int ms, bool& overtime, const buffer_chain& chain)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_write_some(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
 //////////////////////////////////////////////////////////////////////////
 
 tcp_acceptor::tcp_acceptor(boost::asio::io_service& ios)
@@ -347,6 +447,281 @@ void udp_socket::fast_callback()
 #endif
 }
 
+udp_socket::result udp_socket::send_to(my_actor* host, const remote_sender_endpoint& remoteEndpoint, const buffer_chain& chain, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_send_to(remoteEndpoint, chain, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::send_to(my_actor* host, const char* remoteIp, unsigned short remotePort, const buffer_chain& chain, int flags)
+{
+	return udp_socket::send_to(host, remote_sender_endpoint(boost::asio::ip::address::from_string(remoteIp), remotePort), chain, flags);
+}
+
+udp_socket::result udp_socket::send(my_actor* host, const buffer_chain& chain, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_send(chain, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::receive_from(my_actor* host, const buffer_chain& chain, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive_from(chain, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::receive(my_actor* host, const buffer_chain& chain, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive(chain, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::timed_send_to(my_actor* host, int ms, bool& overtime, const remote_sender_endpoint& remoteEndpoint, const buffer_chain& chain, int flags)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_send_to(remoteEndpoint, chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res), flags);
+	if (overtime) res.ok = false;
+	return res;
+}
+
+udp_socket::result udp_socket::timed_send_to(my_actor* host, int ms, bool& overtime, const char* remoteIp, unsigned short remotePort, const buffer_chain& chain, int flags)
+{
+	return timed_send_to(host, ms, overtime, remote_sender_endpoint(boost::asio::ip::address::from_string(remoteIp), remotePort), chain, flags);
+}
+
+udp_socket::result udp_socket::timed_send(my_actor* host, int ms, bool& overtime, const buffer_chain& chain, int flags)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_send(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res), flags);
+	if (overtime) res.ok = false;
+	return res;
+}
+
+udp_socket::result udp_socket::timed_receive_from(my_actor* host, int ms, bool& overtime, const buffer_chain& chain, int flags)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_receive_from(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res), flags);
+	if (overtime) res.ok = false;
+	return res;
+}
+
+udp_socket::result udp_socket::timed_receive(my_actor* host, int ms, bool& overtime, const buffer_chain& chain, int flags)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_receive(chain, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res), flags);
+	if (overtime) res.ok = false;
+	return res;
+}
+
+udp_socket::result udp_socket::receive_many(my_actor* host, datagram* msgs, size_t count, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive_many(msgs, count, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::send_many(my_actor* host, datagram* msgs, size_t count, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_send_many(msgs, count, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::timed_receive_many(my_actor* host, int ms, bool& overtime, datagram* msgs, size_t count, int flags)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_receive_many(msgs, count, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res), flags);
+	if (overtime) res.ok = false;
+	return res;
+}
+
+udp_socket::result udp_socket::timed_send_many(my_actor* host, int ms, bool& overtime, datagram* msgs, size_t count, int flags)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_send_many(msgs, count, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+	}, res), flags);
+	if (overtime) res.ok = false;
+	return res;
+}
+
+size_t udp_socket::receive_many_some(datagram* msgs, size_t count, int flags, boost::system::error_code& ec)
+{
+	ec.clear();
+	size_t n = 0;
+#ifdef __linux__
+	struct mmsghdr hdrs[UDP_MMSG_BATCH];
+	struct iovec iovs[UDP_MMSG_BATCH];
+	while (n < count)
+	{
+		const size_t batch = std::min(count - n, (size_t)UDP_MMSG_BATCH);
+		for (size_t i = 0; i < batch; i++)
+		{
+			datagram& msg = msgs[n + i];
+			iovs[i].iov_base = msg.buff;
+			iovs[i].iov_len = msg.length;
+			memset(&hdrs[i], 0, sizeof(hdrs[i]));
+			hdrs[i].msg_hdr.msg_name = msg.remoteEndpoint.data();
+			hdrs[i].msg_hdr.msg_namelen = (socklen_t)msg.remoteEndpoint.capacity();
+			hdrs[i].msg_hdr.msg_iov = &iovs[i];
+			hdrs[i].msg_hdr.msg_iovlen = 1;
+		}
+		int r = ::recvmmsg(_socket.native_handle(), hdrs, (unsigned)batch, flags | MSG_DONTWAIT, NULL);
+		if (r <= 0)
+		{
+			if (0 == n)
+			{
+				ec = boost::system::error_code(r < 0 ? errno : EAGAIN, boost::asio::error::get_system_category());
+			}
+			break;
+		}
+		for (int i = 0; i < r; i++)
+		{
+			datagram& msg = msgs[n + i];
+			msg.s = hdrs[i].msg_len;
+			msg.remoteEndpoint.resize(hdrs[i].msg_hdr.msg_namelen);
+		}
+		n += r;
+		if ((size_t)r < batch)
+		{
+			break;
+		}
+	}
+#else
+	_socket.non_blocking(true, ec);
+	while (!ec && n < count)
+	{
+		datagram& msg = msgs[n];
+		msg.s = _socket.receive_from(boost::asio::buffer(msg.buff, msg.length), msg.remoteEndpoint, flags, ec);
+		if (!ec)
+		{
+			n++;
+		}
+	}
+	if (n)
+	{
+		ec.clear();
+	}
+#endif
+	if (n)
+	{
+		_remoteSenderEndpoint = msgs[n - 1].remoteEndpoint;
+	}
+	return n;
+}
+
+size_t udp_socket::send_many_some(datagram* msgs, size_t count, int flags, boost::system::error_code& ec)
+{
+	ec.clear();
+	size_t n = 0;
+#ifdef __linux__
+	struct mmsghdr hdrs[UDP_MMSG_BATCH];
+	struct iovec iovs[UDP_MMSG_BATCH];
+	while (n < count)
+	{
+		const size_t batch = std::min(count - n, (size_t)UDP_MMSG_BATCH);
+		for (size_t i = 0; i < batch; i++)
+		{
+			datagram& msg = msgs[n + i];
+			iovs[i].iov_base = msg.buff;
+			iovs[i].iov_len = msg.length;
+			memset(&hdrs[i], 0, sizeof(hdrs[i]));
+			if (msg.remoteEndpoint.port())
+			{
+				hdrs[i].msg_hdr.msg_name = msg.remoteEndpoint.data();
+				hdrs[i].msg_hdr.msg_namelen = (socklen_t)msg.remoteEndpoint.size();
+			}
+			hdrs[i].msg_hdr.msg_iov = &iovs[i];
+			hdrs[i].msg_hdr.msg_iovlen = 1;
+		}
+		int r = ::sendmmsg(_socket.native_handle(), hdrs, (unsigned)batch, flags | MSG_DONTWAIT);
+		if (r <= 0)
+		{
+			ec = boost::system::error_code(r < 0 ? errno : EAGAIN, boost::asio::error::get_system_category());
+			break;
+		}
+		for (int i = 0; i < r; i++)
+		{
+			msgs[n + i].s = hdrs[i].msg_len;
+		}
+		n += r;
+		if ((size_t)r < batch)
+		{
+			break;
+		}
+	}
+#else
+	_socket.non_blocking(true, ec);
+	while (!ec && n < count)
+	{
+		datagram& msg = msgs[n];
+		if (msg.remoteEndpoint.port())
+		{
+			msg.s = _socket.send_to(boost::asio::buffer(msg.buff, msg.length), msg.remoteEndpoint, flags, ec);
+		}
+		else
+		{
+			msg.s = _socket.send(boost::asio::buffer(msg.buff, msg.length), flags, ec);
+		}
+		if (!ec)
+		{
+			n++;
+		}
+	}
+#endif
+	return n;
+}
+
 udp_socket::remote_sender_endpoint udp_socket::make_endpoint(const char* remoteIp, unsigned short remotePort)
 {
 	return remote_sender_endpoint(boost::asio::ip::address::from_string(remoteIp), remotePort);
@@ -6,6 +6,7 @@
 #include <boost/asio/write.hpp>
 #include <boost/asio/read.hpp>
 #include "my_actor.h"
+#include "buffer_chain.h"
 
 /*!
 @brief tcpͨ
@@ -73,6 +74,26 @@ public:
 	*/
 	result write_some(my_actor* host, const void* buff, size_t length);
 
+	/*!
+	@brief ڶȡݣֱƬһreadvɢȡ
+	*/
+	result read(my_actor* host, const buffer_chain& chain);
+
+	/*!
+	@brief ڶȡݣжٶ
+	*/
+	result read_some(my_actor* host, const buffer_chain& chain);
+
+	/*!
+	@brief ڵȫͳȥһwritevۼͣƴӿ
+	*/
+	result write(my_actor* host, const buffer_chain& chain);
+
+	/*!
+	@brief ڵݷͳȥܷǶ
+	*/
+	result write_some(my_actor* host, const buffer_chain& chain);
+
 	/*!
 	@brief msʱ䷶ΧڣͻģʽԶ˷
 	*/
@@ -98,6 +119,26 @@ public:
 	*/
 	result timed_write_some(my_actor* host, int ms, bool& overtime, const void* buff, size_t length);
 
+	/*!
+	@brief msʱ䷶ΧڣڶȡݣֱƬ
+	*/
+	result timed_read(my_actor* host, int ms, bool& overtime, const buffer_chain& chain);
+
+	/*!
+	@brief msʱ䷶Χڣڶȡݣжٶ
+	*/
+	result timed_read_some(my_actor* host, int ms, bool& overtime, const buffer_chain& chain);
+
+	/*!
+	@brief msʱ䷶Χڣڵȫͳȥ
+	*/
+	result timed_write(my_actor* host, int ms, bool& overtime, const buffer_chain& chain);
+
+	/*!
+	@brief msʱ䷶ΧڣڵݷͳȥܷǶ
+	*/
+	result timed_write_some(my_actor* host, int ms, bool& overtime, const buffer_chain& chain);
+
 	/*!
 	@brief رsocket
 	*/
@@ -167,6 +208,58 @@ public:
 			handler(res);
 		}, std::forward<Handler>(handler), __1, __2));
 	}
+
+	/*!
+	@brief 첽ģʽ£ڶȡݣֱƬasioڲƬü֤첽ڼڴЧ
+	*/
+	template <typename Handler>
+	void async_read(const buffer_chain& chain, Handler&& handler)
+	{
+		boost::asio::async_read(_socket, chain, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£ڶȡݣжٶ
+	*/
+	template <typename Handler>
+	void async_read_some(const buffer_chain& chain, Handler&& handler)
+	{
+		_socket.async_read_some(chain, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£ڵȫͳȥ
+	*/
+	template <typename Handler>
+	void async_write(const buffer_chain& chain, Handler&& handler)
+	{
+		boost::asio::async_write(_socket, chain, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£ڵݷͳȥܷǶ
+	*/
+	template <typename Handler>
+	void async_write_some(const buffer_chain& chain, Handler&& handler)
+	{
+		_socket.async_write_some(chain, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
 private:
 	boost::asio::ip::tcp::socket _socket;
 	NONE_COPY(tcp_socket);
@@ -249,6 +342,17 @@ public:
 		int code;///<
 		bool ok;///<Ƿɹ
 	};
+
+	/*!
+	@brief receive_many/send_manyշݱ
+	*/
+	struct datagram
+	{
+		void* buff;///<
+		size_t length;///<ʱΪȣʱΪݳ
+		size_t s;///<ʵշֽ
+		remote_sender_endpoint remoteEndpoint;///<ʱΪԶ˵ַʱΪĿַ˿Ϊ0ʱĬĿ(connectɹ)
+	};
 public:
 	udp_socket(boost::asio::io_service& ios);
 	~udp_socket();
@@ -334,6 +438,41 @@ public:
 	*/
 	result receive(my_actor* host, void* buff, size_t length, int flags = 0);
 
+	/*!
+	@brief Ϊһݱ͵ָĿ꣨sendmsgۼͣ
+	*/
+	result send_to(my_actor* host, const remote_sender_endpoint& remoteEndpoint, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief Ϊһݱ͵ָĿ
+	*/
+	result send_to(my_actor* host, const char* remoteIp, unsigned short remotePort, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief Ϊһݱ͵ĬĿ(connectɹ)
+	*/
+	result send(my_actor* host, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief һݱɢ¼Զ˵ַ
+	*/
+	result receive_from(my_actor* host, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief һݱɢ
+	*/
+	result receive(my_actor* host, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief һνնݱ(Linuxrecvmmsg)յһ󷵻أresult.sΪյݱ
+	*/
+	result receive_many(my_actor* host, datagram* msgs, size_t count, int flags = 0);
+
+	/*!
+	@brief һηͶݱ(Linuxsendmmsg)ȫ󷵻أresult.sΪѷ͵ݱ
+	*/
+	result send_many(my_actor* host, datagram* msgs, size_t count, int flags = 0);
+
 	/*!
 	@brief msʱ䷶ΧڣͶ趨һԶ̶˿ΪĬϷͽĿ
 	*/
@@ -364,6 +503,41 @@ public:
 	*/
 	result timed_receive(my_actor* host, int ms, bool& overtime, void* buff, size_t length, int flags = 0);
 
+	/*!
+	@brief msʱ䷶ΧڣΪһݱ͵ָĿ
+	*/
+	result timed_send_to(my_actor* host, int ms, bool& overtime, const remote_sender_endpoint& remoteEndpoint, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief msʱ䷶ΧڣΪһݱ͵ָĿ
+	*/
+	result timed_send_to(my_actor* host, int ms, bool& overtime, const char* remoteIp, unsigned short remotePort, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief msʱ䷶ΧڣΪһݱ͵ĬĿ(connectɹ)
+	*/
+	result timed_send(my_actor* host, int ms, bool& overtime, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief msʱ䷶Χڣһݱɢ¼Զ˵ַ
+	*/
+	result timed_receive_from(my_actor* host, int ms, bool& overtime, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief msʱ䷶Χڣһݱɢ
+	*/
+	result timed_receive(my_actor* host, int ms, bool& overtime, const buffer_chain& chain, int flags = 0);
+
+	/*!
+	@brief msʱ䷶Χڣһνնݱյһ󷵻
+	*/
+	result timed_receive_many(my_actor* host, int ms, bool& overtime, datagram* msgs, size_t count, int flags = 0);
+
+	/*!
+	@brief msʱ䷶ΧڣһηͶݱȫ󷵻
+	*/
+	result timed_send_many(my_actor* host, int ms, bool& overtime, datagram* msgs, size_t count, int flags = 0);
+
 	/*!
 	@brief һԶĿ
 	*/
@@ -452,6 +626,132 @@ public:
 			handler(res);
 		}, std::forward<Handler>(handler), __1, __2));
 	}
+
+	/*!
+	@brief 첽ģʽ£Ϊһݱ͵ָĿ
+	*/
+	template <typename Handler>
+	void async_send_to(const remote_sender_endpoint& remoteEndpoint, const buffer_chain& chain, Handler&& handler, int flags = 0)
+	{
+		_socket.async_send_to(chain, remoteEndpoint, flags, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£Ϊһݱ͵ָĿ
+	*/
+	template <typename Handler>
+	void async_send_to(const char* remoteIp, unsigned short remotePort, const buffer_chain& chain, Handler&& handler, int flags = 0)
+	{
+		async_send_to(remote_sender_endpoint(boost::asio::ip::address::from_string(remoteIp), remotePort), chain, std::forward<Handler>(handler), flags);
+	}
+
+	/*!
+	@brief 첽ģʽ£Ϊһݱ͵ĬĿ(connectɹ)
+	*/
+	template <typename Handler>
+	void async_send(const buffer_chain& chain, Handler&& handler, int flags = 0)
+	{
+		_socket.async_send(chain, flags, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£һݱɢ¼Զ˵ַ
+	*/
+	template <typename Handler>
+	void async_receive_from(const buffer_chain& chain, Handler&& handler, int flags = 0)
+	{
+		_socket.async_receive_from(chain, _remoteSenderEndpoint, flags, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£һݱɢ
+	*/
+	template <typename Handler>
+	void async_receive(const buffer_chain& chain, Handler&& handler, int flags = 0)
+	{
+		_socket.async_receive(chain, flags, std::bind([](Handler& handler, const boost::system::error_code& ec, size_t s)
+		{
+			result res = { s, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+	/*!
+	@brief 첽ģʽ£һνնݱյһصresult.sΪյݱ
+	*/
+	template <typename Handler>
+	void async_receive_many(datagram* msgs, size_t count, Handler&& handler, int flags = 0)
+	{
+		_socket.async_receive(boost::asio::null_buffers(), std::bind([this, msgs, count, flags](Handler& handler, const boost::system::error_code& ec, size_t)
+		{
+			result res = { 0, ec.value(), !ec };
+			if (!ec)
+			{
+				boost::system::error_code rec;
+				res.s = receive_many_some(msgs, count, flags, rec);
+				if (0 == res.s && boost::asio::error::would_block == rec)
+				{//ɶ֪ͨѱȡߣȴ
+					async_receive_many(msgs, count, std::move(handler), flags);
+					return;
+				}
+				res.code = rec.value();
+				res.ok = 0 != res.s;
+			}
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief 첽ģʽ£һηͶݱȫصresult.sΪѷ͵ݱ
+	*/
+	template <typename Handler>
+	void async_send_many(datagram* msgs, size_t count, Handler&& handler, int flags = 0)
+	{
+		_async_send_many(msgs, count, 0, std::forward<Handler>(handler), flags);
+	}
+private:
+	template <typename Handler>
+	void _async_send_many(datagram* msgs, size_t count, size_t sent, Handler&& handler, int flags)
+	{
+		_socket.async_send(boost::asio::null_buffers(), std::bind([this, msgs, count, sent, flags](Handler& handler, const boost::system::error_code& ec, size_t)
+		{
+			result res = { sent, ec.value(), !ec };
+			if (!ec)
+			{
+				boost::system::error_code sec;
+				res.s += send_many_some(msgs + sent, count - sent, flags, sec);
+				if (res.s < count && (!sec || boost::asio::error::would_block == sec))
+				{//ͻȴд
+					_async_send_many(msgs, count, res.s, std::move(handler), flags);
+					return;
+				}
+				res.code = res.s < count ? sec.value() : 0;
+				res.ok = res.s == count;
+			}
+			handler(res);
+		}, std::forward<Handler>(handler), __1, __2));
+	}
+
+	/*!
+	@brief վܶݱյĸ
+	*/
+	size_t receive_many_some(datagram* msgs, size_t count, int flags, boost::system::error_code& ec);
+
+	/*!
+	@brief ;ܶݱطĸ
+	*/
+	size_t send_many_some(datagram* msgs, size_t count, int flags, boost::system::error_code& ec);
 private:
 	boost::asio::ip::udp::socket _socket;
 	boost::asio::ip::udp::endpoint _remoteSenderEndpoint;
@@ -32,7 +32,11 @@ _extMaxTick(0), _extFinishTime(-1), _handlerQueue(MEM_POOL_LENGTH)
 ActorTimer_::~ActorTimer_()
 {
 	assert(_handlerQueue.empty());
+#ifdef DISABLE_BOOST_TIMER
+	((timer_type*)_timer)->destroy();
+#else
 	delete (timer_type*)_timer;
+#endif
 }
 
 ActorTimer_::timer_handle ActorTimer_::timeout(long long us, actor_face_handle&& host, bool deadline)
@@ -46,9 +50,13 @@ ActorTimer_::timer_handle ActorTimer_::timeout(long long us, actor_face_handle&&
 #endif
 	}
 	assert(_lockStrand->running_in_this_thread());
+	EVENT_TRACE(et_timer_arm, this);
 	timer_handle timerHandle;
 	timerHandle._beginStamp = get_tick_us();
 	long long et = deadline ? us : (timerHandle._beginStamp + us);
+#ifdef ENABLE_TIMER_WHEEL
+	timerHandle._queueNode = _handlerQueue.insert(et, timerHandle._beginStamp, std::move(host));
+#else
 	if (et >= _extMaxTick)
 	{
 		_extMaxTick = et;
@@ -58,6 +66,7 @@ ActorTimer_::timer_handle ActorTimer_::timeout(long long us, actor_face_handle&&
 	{
 		timerHandle._queueNode = _handlerQueue.insert(std::make_pair(et, std::move(host)));
 	}
+#endif
 	
 	if (!_looping)
 	{//ʱѾ˳ѭʱ
@@ -95,6 +104,12 @@ void ActorTimer_::cancel(timer_handle& th)
 			_timerCount++;
 			_looping = false;
 		} 
+#ifdef ENABLE_TIMER_WHEEL
+		else
+		{
+			_handlerQueue.erase(itNode);
+		}
+#else
 		else if (itNode->first == _extMaxTick)
 		{
 			_handlerQueue.erase(itNode++);
@@ -108,6 +123,7 @@ void ActorTimer_::cancel(timer_handle& th)
 		{
 			_handlerQueue.erase(itNode);
 		}
+#endif
 	}
 }
 
@@ -153,6 +169,16 @@ void ActorTimer_::event_handler(int tc)
 		_extFinishTime = 0;
 		while (!_handlerQueue.empty())
 		{
+#ifdef ENABLE_TIMER_WHEEL
+			long long ct = get_tick_us();
+			handler_queue::iterator iter = _handlerQueue.expired(ct);
+			if (!iter)
+			{
+				_extFinishTime = _handlerQueue.next_deadline();
+				timer_loop(_extFinishTime, _extFinishTime - ct);
+				return;
+			}
+#else
 			handler_queue::iterator iter = _handlerQueue.begin();
 			long long ct = get_tick_us();
 			if (iter->first > ct)
@@ -161,8 +187,10 @@ void ActorTimer_::event_handler(int tc)
 				timer_loop(_extFinishTime, _extFinishTime - ct);
 				return;
 			}
+#endif
 			else
 			{
+				EVENT_TRACE(et_timer_fire, this);
 				iter->second->timeout_handler();
 				_handlerQueue.erase(iter);
 			}
@@ -22,7 +22,11 @@ class ActorTimer_
 #endif
 {
 	typedef std::shared_ptr<ActorTimerFace_> actor_face_handle;
+#ifdef ENABLE_TIMER_WHEEL
+	typedef msg_timer_wheel<actor_face_handle> handler_queue;
+#else
 	typedef msg_multimap<long long, actor_face_handle> handler_queue;
+#endif
 
 	friend boost_strand;
 	friend qt_strand;
@@ -144,7 +144,11 @@ _extMaxTick(0), _extFinishTime(-1), _handlerQueue(MEM_POOL_LENGTH)
 overlap_timer::~overlap_timer()
 {
 	assert(_handlerQueue.empty());
+#ifdef DISABLE_BOOST_TIMER
+	((timer_type*)_timer)->destroy();
+#else
 	delete (timer_type*)_timer;
+#endif
 }
 
 void overlap_timer::_timeout(long long us, timer_handle& timerHandle, bool deadline)
@@ -159,6 +163,9 @@ void overlap_timer::_timeout(long long us, timer_handle& timerHandle, bool deadl
 	assert(_lockStrand->running_in_this_thread());
 	timerHandle._timestamp = get_tick_us();
 	long long et = deadline ? us : (timerHandle._timestamp + us);
+#ifdef ENABLE_TIMER_WHEEL
+	timerHandle._queueNode = _handlerQueue.insert(et, timerHandle._timestamp, &timerHandle);
+#else
 	if (et >= _extMaxTick)
 	{
 		_extMaxTick = et;
@@ -168,6 +175,7 @@ void overlap_timer::_timeout(long long us, timer_handle& timerHandle, bool deadl
 	{
 		timerHandle._queueNode = _handlerQueue.insert(std::make_pair(et, &timerHandle));
 	}
+#endif
 
 	if (!_looping)
 	{//ʱѾ˳ѭʱ
@@ -202,6 +210,12 @@ void overlap_timer::_cancel(timer_handle& timerHandle)
 			_timerCount++;
 			_looping = false;
 		}
+#ifdef ENABLE_TIMER_WHEEL
+		else
+		{
+			_handlerQueue.erase(itNode);
+		}
+#else
 		else if (itNode->first == _extMaxTick)
 		{
 			_handlerQueue.erase(itNode++);
@@ -215,6 +229,7 @@ void overlap_timer::_cancel(timer_handle& timerHandle)
 		{
 			_handlerQueue.erase(itNode);
 		}
+#endif
 	}
 }
 
@@ -332,6 +347,16 @@ void overlap_timer::event_handler(int tc)
 		_extFinishTime = 0;
 		while (!_handlerQueue.empty())
 		{
+#ifdef ENABLE_TIMER_WHEEL
+			long long ct = get_tick_us();
+			handler_queue::iterator iter = _handlerQueue.expired(ct);
+			if (!iter)
+			{
+				_extFinishTime = _handlerQueue.next_deadline();
+				timer_loop(_extFinishTime, _extFinishTime - ct);
+				return;
+			}
+#else
 			handler_queue::iterator iter = _handlerQueue.begin();
 			long long ct = get_tick_us();
 			if (iter->first > ct)
@@ -340,6 +365,7 @@ void overlap_timer::event_handler(int tc)
 				timer_loop(_extFinishTime, _extFinishTime - ct);
 				return;
 			}
+#endif
 			else
 			{
 				timer_handle* const timerHandle = iter->second;
@@ -380,7 +380,11 @@ class overlap_timer
 public:
 	class timer_handle;
 private:
+#ifdef ENABLE_TIMER_WHEEL
+	typedef msg_timer_wheel<timer_handle*> handler_queue;
+#else
 	typedef msg_multimap<long long, timer_handle*> handler_queue;
+#endif
 
 	friend boost_strand;
 	friend qt_strand;
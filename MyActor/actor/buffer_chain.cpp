@@ -0,0 +1,96 @@
+#include "buffer_chain.h"
+
+buffer_pool::buffer_pool(size_t blockSize, size_t poolSize)
+:_alloc(sizeof(block_head) + blockSize, poolSize), _blockSize(blockSize) {}
+
+buffer_pool::~buffer_pool()
+{
+}
+
+shared_buffer_pool buffer_pool::create(size_t blockSize, size_t poolSize)
+{
+	shared_buffer_pool res(new buffer_pool(MEM_ALIGN(blockSize, sizeof(void*)), poolSize));
+	res->_weakThis = res;
+	return res;
+}
+
+buffer_slice buffer_pool::alloc(size_t size)
+{
+	block_head* block = NULL;
+	if (size <= _blockSize)
+	{
+		block = new(_alloc.allocate())block_head;
+		block->_pool = _weakThis.lock();
+		block->_capacity = _blockSize;
+	}
+	else
+	{
+		block = new(malloc(sizeof(block_head) + size))block_head;
+		block->_capacity = size;
+	}
+	block->_refCount = 1;
+	buffer_slice res;
+	res._block = block;
+	res._data = (char*)(block + 1);
+	res._size = size;
+	return res;
+}
+
+buffer_slice buffer_pool::alloc_copy(const void* data, size_t size)
+{
+	buffer_slice res = alloc(size);
+	memcpy(res.data(), data, size);
+	return res;
+}
+
+size_t buffer_pool::block_size() const
+{
+	return _blockSize;
+}
+
+void buffer_pool::release(block_head* block)
+{
+	if (block->_pool)
+	{
+		//ȡãֹ黹ʱ
+		shared_buffer_pool pool = std::move(block->_pool);
+		block->~block_head();
+		pool->_alloc.deallocate(block);
+	}
+	else
+	{
+		block->~block_head();
+		free(block);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void buffer_chain::consume(size_t n)
+{
+	size_t i = 0;
+	for (; i < _slices.size() && n >= _slices[i].size(); i++)
+	{
+		n -= _slices[i].size();
+	}
+	_slices.erase(_slices.begin(), _slices.begin() + i);
+	if (n && !_slices.empty())
+	{
+		buffer_slice& front = _slices.front();
+		front = front.slice(n, front.size() - n);
+	}
+}
+
+void buffer_chain::truncate(size_t n)
+{
+	size_t i = 0;
+	for (; i < _slices.size() && n > _slices[i].size(); i++)
+	{
+		n -= _slices[i].size();
+	}
+	if (i < _slices.size())
+	{
+		_slices[i].resize(n);
+		_slices.erase(_slices.begin() + i + 1, _slices.end());
+	}
+}
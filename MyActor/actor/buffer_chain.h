@@ -0,0 +1,358 @@
+#ifndef __BUFFER_CHAIN_H
+#define __BUFFER_CHAIN_H
+
+#include <boost/asio/buffer.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <iterator>
+#include "mem_pool.h"
+#include "scattered.h"
+
+class buffer_pool;
+class buffer_slice;
+class buffer_chain;
+typedef std::shared_ptr<buffer_pool> shared_buffer_pool;
+
+/*!
+@brief أüڴ飬ƬͷźڴصУɿ߳ͷ
+*/
+class buffer_pool
+{
+	friend buffer_slice;
+
+	struct block_head
+	{
+		std::atomic<size_t> _refCount;
+		shared_buffer_pool _pool;//ΪʱʾؿߴĶ
+		size_t _capacity;
+	};
+private:
+	buffer_pool(size_t blockSize, size_t poolSize);
+public:
+	~buffer_pool();
+public:
+	/*!
+	@brief 
+	@param blockSize ڴߴ
+	@param poolSize ໺Ŀп
+	*/
+	static shared_buffer_pool create(size_t blockSize = 4096, size_t poolSize = 1024);
+
+	/*!
+	@brief sizeֽڵƬblock_size()ʱӳȡ飬
+	*/
+	buffer_slice alloc(size_t size);
+
+	/*!
+	@brief һƬ
+	*/
+	buffer_slice alloc_copy(const void* data, size_t size);
+
+	/*!
+	@brief ڴߴ
+	*/
+	size_t block_size() const;
+private:
+	static void release(block_head* block);
+private:
+	dymem_alloc_mt<std::mutex> _alloc;
+	std::weak_ptr<buffer_pool> _weakThis;
+	const size_t _blockSize;
+	NONE_COPY(buffer_pool);
+};
+
+/*!
+@brief ƬڴеһΣʱֻü
+*/
+class buffer_slice
+{
+	friend buffer_pool;
+public:
+	buffer_slice()
+		:_block(NULL), _data(NULL), _size(0) {}
+
+	buffer_slice(const buffer_slice& s)
+		:_block(s._block), _data(s._data), _size(s._size)
+	{
+		if (_block)
+		{
+			_block->_refCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	buffer_slice(buffer_slice&& s)
+		:_block(s._block), _data(s._data), _size(s._size)
+	{
+		s._block = NULL;
+		s._data = NULL;
+		s._size = 0;
+	}
+
+	~buffer_slice()
+	{
+		reset();
+	}
+
+	buffer_slice& operator=(const buffer_slice& s)
+	{
+		if (this != &s)
+		{
+			if (s._block)
+			{
+				s._block->_refCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			reset();
+			_block = s._block;
+			_data = s._data;
+			_size = s._size;
+		}
+		return *this;
+	}
+
+	buffer_slice& operator=(buffer_slice&& s)
+	{
+		if (this != &s)
+		{
+			reset();
+			_block = s._block;
+			_data = s._data;
+			_size = s._size;
+			s._block = NULL;
+			s._data = NULL;
+			s._size = 0;
+		}
+		return *this;
+	}
+public:
+	char* data() const
+	{
+		return _data;
+	}
+
+	size_t size() const
+	{
+		return _size;
+	}
+
+	bool empty() const
+	{
+		return 0 == _size;
+	}
+
+	/*!
+	@brief data()ڴĩβĿóߴ
+	*/
+	size_t capacity() const
+	{
+		return _block ? (char*)(_block + 1) + _block->_capacity - _data : 0;
+	}
+
+	/*!
+	@brief Ƭߴ(capacity())read_someضϵʵʶȡĳ
+	*/
+	void resize(size_t size)
+	{
+		assert(size <= capacity());
+		_size = size;
+	}
+
+	/*!
+	@brief ȡ[offset, offset+length)֣뱾Ƭڴ
+	*/
+	buffer_slice slice(size_t offset, size_t length) const
+	{
+		assert(offset + length <= _size);
+		buffer_slice res(*this);
+		res._data += offset;
+		res._size = length;
+		return res;
+	}
+
+	/*!
+	@brief ͷ
+	*/
+	void reset()
+	{
+		if (_block)
+		{
+			if (1 == _block->_refCount.fetch_sub(1, std::memory_order_acq_rel))
+			{
+				buffer_pool::release(_block);
+			}
+			_block = NULL;
+			_data = NULL;
+			_size = 0;
+		}
+	}
+private:
+	buffer_pool::block_head* _block;
+	char* _data;
+	size_t _size;
+};
+
+/*!
+@brief ƬһasioУscatter/gatherдһreadv/writev
+*/
+class buffer_chain
+{
+public:
+	typedef boost::asio::mutable_buffer value_type;
+
+	class const_iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef boost::asio::mutable_buffer value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const boost::asio::mutable_buffer* pointer;
+		typedef boost::asio::mutable_buffer reference;
+
+		const_iterator() {}
+
+		explicit const_iterator(std::vector<buffer_slice>::const_iterator it)
+			:_it(it) {}
+
+		reference operator*() const
+		{
+			return boost::asio::mutable_buffer(_it->data(), _it->size());
+		}
+
+		const_iterator& operator++()
+		{
+			++_it;
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			return const_iterator(_it++);
+		}
+
+		const_iterator& operator--()
+		{
+			--_it;
+			return *this;
+		}
+
+		const_iterator operator--(int)
+		{
+			return const_iterator(_it--);
+		}
+
+		bool operator==(const const_iterator& s) const
+		{
+			return _it == s._it;
+		}
+
+		bool operator!=(const const_iterator& s) const
+		{
+			return _it != s._it;
+		}
+	private:
+		std::vector<buffer_slice>::const_iterator _it;
+	};
+public:
+	buffer_chain() {}
+
+	buffer_chain(const buffer_chain& s)
+		:_slices(s._slices) {}
+
+	buffer_chain(buffer_chain&& s)
+		:_slices(std::move(s._slices)) {}
+
+	buffer_chain& operator=(const buffer_chain& s)
+	{
+		_slices = s._slices;
+		return *this;
+	}
+
+	buffer_chain& operator=(buffer_chain&& s)
+	{
+		_slices = std::move(s._slices);
+		return *this;
+	}
+public:
+	void push_back(const buffer_slice& slice)
+	{
+		_slices.push_back(slice);
+	}
+
+	void push_back(buffer_slice&& slice)
+	{
+		_slices.push_back(std::move(slice));
+	}
+
+	/*!
+	@brief ׷һƬ
+	*/
+	void append(const buffer_chain& other)
+	{
+		_slices.insert(_slices.end(), other._slices.begin(), other._slices.end());
+	}
+
+	/*!
+	@brief Ƭ
+	*/
+	size_t count() const
+	{
+		return _slices.size();
+	}
+
+	/*!
+	@brief ֽ
+	*/
+	size_t bytes() const
+	{
+		size_t res = 0;
+		for (const buffer_slice& ele : _slices)
+		{
+			res += ele.size();
+		}
+		return res;
+	}
+
+	bool empty() const
+	{
+		return _slices.empty();
+	}
+
+	void clear()
+	{
+		_slices.clear();
+	}
+
+	buffer_slice& operator[](size_t i)
+	{
+		return _slices[i];
+	}
+
+	const buffer_slice& operator[](size_t i) const
+	{
+		return _slices[i];
+	}
+
+	/*!
+	@brief ǰnֽڣwrite_someʣಿ
+	*/
+	void consume(size_t n);
+
+	/*!
+	@brief ֻǰnֽڣread_someضϵʵʶȡĳ
+	*/
+	void truncate(size_t n);
+
+	const_iterator begin() const
+	{
+		return const_iterator(_slices.begin());
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(_slices.end());
+	}
+private:
+	std::vector<buffer_slice> _slices;
+};
+
+#endif
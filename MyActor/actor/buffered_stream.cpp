@@ -0,0 +1,293 @@
+#include "buffered_stream.h"
+
+buffered_reader::buffered_reader(tcp_socket& socket, const shared_buffer_pool& pool)
+:_socket(socket), _buff(pool->alloc(pool->block_size())), _begin(0), _end(0), _scanned(0), _scanDelim(0), _closed(shared_bool::new_()) {}
+
+buffered_reader::~buffered_reader()
+{
+	_closed = true;
+}
+
+const char* buffered_reader::data() const
+{
+	return _buff.data() + _begin;
+}
+
+size_t buffered_reader::size() const
+{
+	return _end - _begin;
+}
+
+size_t buffered_reader::capacity() const
+{
+	return _buff.size();
+}
+
+void buffered_reader::consume(size_t n)
+{
+	assert(n <= size());
+	_begin += n;
+	if (_begin == _end)
+	{
+		_begin = _end = _scanned = 0;
+	}
+	else if (_scanned < _begin)
+	{
+		_scanned = _begin;
+	}
+}
+
+void buffered_reader::compact()
+{
+	if (_begin)
+	{
+		memmove(_buff.data(), _buff.data() + _begin, _end - _begin);
+		_end -= _begin;
+		_scanned -= _begin;
+		_begin = 0;
+	}
+}
+
+size_t buffered_reader::take(void* buff, size_t n)
+{
+	const size_t c = std::min(n, size());
+	memcpy(buff, data(), c);
+	consume(c);
+	return c;
+}
+
+size_t buffered_reader::scan(char delim)
+{
+	if (delim != _scanDelim)
+	{
+		_scanDelim = delim;
+		_scanned = _begin;
+	}
+	const char* p = (const char*)memchr(_buff.data() + _scanned, delim, _end - _scanned);
+	if (p)
+	{
+		_scanned = p - _buff.data();
+		return p + 1 - data();
+	}
+	_scanned = _end;
+	return 0;
+}
+
+buffered_reader::result buffered_reader::peek(my_actor* host, size_t n)
+{
+	if (size() >= n)
+	{
+		result res = { n, 0, true };
+		return res;
+	}
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_peek(n, std::move(h));
+	});
+}
+
+buffered_reader::result buffered_reader::read_exact(my_actor* host, void* buff, size_t n)
+{
+	if (size() >= n)
+	{
+		take(buff, n);
+		result res = { n, 0, true };
+		return res;
+	}
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_read_exact(buff, n, std::move(h));
+	});
+}
+
+buffered_reader::result buffered_reader::read_until(my_actor* host, char delim)
+{
+	const size_t s = scan(delim);
+	if (s)
+	{
+		result res = { s, 0, true };
+		return res;
+	}
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_read_until(delim, std::move(h));
+	});
+}
+
+buffered_reader::result buffered_reader::read_until(my_actor* host, char delim, std::string& out)
+{
+	result res = read_until(host, delim);
+	if (res.ok)
+	{
+		out.assign(data(), res.s);
+		consume(res.s);
+	}
+	return res;
+}
+
+buffered_reader::result buffered_reader::timed_peek(my_actor* host, int ms, bool& overtime, size_t n)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_peek(n, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		_socket.close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
+
+buffered_reader::result buffered_reader::timed_read_exact(my_actor* host, int ms, bool& overtime, void* buff, size_t n)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_read_exact(buff, n, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		_socket.close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
+
+buffered_reader::result buffered_reader::timed_read_until(my_actor* host, int ms, bool& overtime, char delim)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_read_until(delim, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		_socket.close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
+//////////////////////////////////////////////////////////////////////////
+
+buffered_writer::buffered_writer(const shared_strand& strand, tcp_socket& socket, const shared_buffer_pool& pool, size_t flushThreshold)
+:_strand(strand), _socket(socket), _front(pool->alloc(pool->block_size())), _back(pool->alloc(pool->block_size())),
+_frontSize(0), _backSize(0), _errorCode(0), _flushing(false), _ticking(false), _closed(shared_bool::new_())
+{
+	_threshold = (0 == flushThreshold || flushThreshold > _front.size()) ? _front.size() : flushThreshold;
+}
+
+buffered_writer::~buffered_writer()
+{
+	_closed = true;
+}
+
+size_t buffered_writer::size() const
+{
+	return _frontSize + (_flushing ? _backSize : 0);
+}
+
+bool buffered_writer::append(const void* data, size_t length)
+{
+	if (_frontSize + length > _front.size())
+	{
+		return false;
+	}
+	memcpy(_front.data() + _frontSize, data, length);
+	_frontSize += length;
+	if (!_flushing && _frontSize >= _threshold)
+	{
+		start_flush();
+	}
+	else if (!_ticking)
+	{//ǰactor/generatoróstrandٷͣϲд
+		_ticking = true;
+		_strand->next_tick(std::bind([this](shared_bool& closed)
+		{
+			if (!closed)
+			{
+				_ticking = false;
+				if (!_flushing && _frontSize && !_errorCode)
+				{
+					start_flush();
+				}
+			}
+		}, _closed));
+	}
+	return true;
+}
+
+void buffered_writer::start_flush()
+{
+	assert(!_flushing && _frontSize);
+	std::swap(_front, _back);
+	_backSize = _frontSize;
+	_frontSize = 0;
+	_flushing = true;
+	_socket.async_write(_back.data(), _backSize, _strand->wrap(std::bind([this](shared_bool& closed, buffer_slice&, const result& res)
+	{
+		if (!closed)
+		{
+			flush_completed(res);
+		}
+	}, _closed, _back, __1)));
+}
+
+void buffered_writer::flush_completed(const result& res)
+{
+	_flushing = false;
+	_backSize = 0;
+	if (!res.ok)
+	{
+		_errorCode = res.code ? res.code : (int)boost::asio::error::broken_pipe;
+	}
+	else if (_frontSize)
+	{
+		start_flush();
+	}
+	if (_waiter)
+	{
+		std::function<void()> waiter;
+		waiter.swap(_waiter);
+		waiter();
+	}
+}
+
+buffered_writer::result buffered_writer::write(my_actor* host, const void* data, size_t length)
+{
+	assert(_strand->running_in_this_thread());
+	if (!_errorCode && !_waiter && append(data, length))
+	{
+		result res = { length, 0, true };
+		return res;
+	}
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_write(data, length, std::move(h));
+	});
+}
+
+buffered_writer::result buffered_writer::flush(my_actor* host)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_flush(std::move(h));
+	});
+}
+
+buffered_writer::result buffered_writer::timed_flush(my_actor* host, int ms, bool& overtime)
+{
+	overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_flush(host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		_socket.close();
+	}, res));
+	if (overtime) res.ok = false;
+	return res;
+}
@@ -0,0 +1,386 @@
+#ifndef __BUFFERED_STREAM_H
+#define __BUFFERED_STREAM_H
+
+#include <string>
+#include "actor_socket.h"
+#include "buffer_chain.h"
+
+/*!
+@brief tcp_socketϵĴȡbuffer_poolз䣻
+ʱͬأactorлͬһʱֻһȡ
+*/
+class buffered_reader
+{
+public:
+	typedef tcp_socket::result result;
+public:
+	buffered_reader(tcp_socket& socket, const shared_buffer_pool& pool);
+	~buffered_reader();
+public:
+	/*!
+	@brief ѻδѵ
+	*/
+	const char* data() const;
+
+	/*!
+	@brief ѻδѵֽ
+	*/
+	size_t size() const;
+
+	/*!
+	@brief peek/read_untilһֽܿ
+	*/
+	size_t capacity() const;
+
+	/*!
+	@brief ѵǰnֽ
+	*/
+	void consume(size_t n);
+
+	/*!
+	@brief ֤nֽڣѣ֮data()ȡ
+	*/
+	result peek(my_actor* host, size_t n);
+
+	/*!
+	@brief ȡnֽڵbuffԽֱӶȡ
+	*/
+	result read_exact(my_actor* host, void* buff, size_t n);
+
+	/*!
+	@brief ȡֱdelimѣresult.sΪdelimĳȣ֮data()ȡconsume(result.s)
+	*/
+	result read_until(my_actor* host, char delim);
+
+	/*!
+	@brief ȡֱdelimout(delim)
+	*/
+	result read_until(my_actor* host, char delim, std::string& out);
+
+	/*!
+	@brief msʱ䷶Χڣ֤nֽڣʱرsocket
+	*/
+	result timed_peek(my_actor* host, int ms, bool& overtime, size_t n);
+
+	/*!
+	@brief msʱ䷶Χڣȡnֽڵbuff
+	*/
+	result timed_read_exact(my_actor* host, int ms, bool& overtime, void* buff, size_t n);
+
+	/*!
+	@brief msʱ䷶Χڣȡֱdelim
+	*/
+	result timed_read_until(my_actor* host, int ms, bool& overtime, char delim);
+
+	/*!
+	@brief 첽ģʽ£֤nֽ
+	*/
+	template <typename Handler>
+	void async_peek(size_t n, Handler&& handler)
+	{
+		if (size() >= n)
+		{
+			result res = { n, 0, true };
+			handler(res);
+			return;
+		}
+		if (n > capacity())
+		{
+			result res = { 0, boost::asio::error::no_buffer_space, false };
+			handler(res);
+			return;
+		}
+		async_fill([this, n, handler](const result& res) mutable
+		{
+			if (res.ok)
+			{
+				async_peek(n, std::move(handler));
+			}
+			else
+			{
+				handler(res);
+			}
+		});
+	}
+
+	/*!
+	@brief 첽ģʽ£ȡnֽڵbuff
+	*/
+	template <typename Handler>
+	void async_read_exact(void* buff, size_t n, Handler&& handler)
+	{
+		const size_t c = take(buff, n);
+		if (c == n)
+		{
+			result res = { n, 0, true };
+			handler(res);
+			return;
+		}
+		char* const rest = (char*)buff + c;
+		const size_t restSize = n - c;
+		if (restSize >= capacity() / 2)
+		{//ֱӶĿ꣬ο
+			_socket.async_read(rest, restSize, [c, handler](result res) mutable
+			{
+				res.s += c;
+				handler(res);
+			});
+			return;
+		}
+		async_peek(restSize, [this, c, rest, restSize, handler](result res) mutable
+		{
+			if (res.ok)
+			{
+				take(rest, restSize);
+				res.s = c + restSize;
+			}
+			else
+			{
+				res.s = c;
+			}
+			handler(res);
+		});
+	}
+
+	/*!
+	@brief 첽ģʽ£ȡֱdelimѣresult.sΪdelimĳ
+	*/
+	template <typename Handler>
+	void async_read_until(char delim, Handler&& handler)
+	{
+		const size_t s = scan(delim);
+		if (s)
+		{
+			result res = { s, 0, true };
+			handler(res);
+			return;
+		}
+		if (size() == capacity())
+		{
+			result res = { 0, boost::asio::error::no_buffer_space, false };
+			handler(res);
+			return;
+		}
+		async_fill([this, delim, handler](const result& res) mutable
+		{
+			if (res.ok)
+			{
+				async_read_until(delim, std::move(handler));
+			}
+			else
+			{
+				handler(res);
+			}
+		});
+	}
+private:
+	/*!
+	@brief һsocket仺
+	*/
+	template <typename Handler>
+	void async_fill(Handler&& handler)
+	{
+		compact();
+		shared_bool closed = _closed;
+		buffer_slice buff = _buff;
+		_socket.async_read_some(_buff.data() + _end, capacity() - _end, [this, closed, buff, handler](const result& res) mutable
+		{
+			if (!closed)
+			{
+				if (res.ok)
+				{
+					_end += res.s;
+				}
+				handler(res);
+			}
+		});
+	}
+
+	/*!
+	@brief δƵͷ
+	*/
+	void compact();
+
+	/*!
+	@brief ӻȡnֽڣȡֽ
+	*/
+	size_t take(void* buff, size_t n);
+
+	/*!
+	@brief ڻвdelimذdelimĳȣûҵ0
+	*/
+	size_t scan(char delim);
+private:
+	tcp_socket& _socket;
+	buffer_slice _buff;
+	size_t _begin;
+	size_t _end;
+	size_t _scanned;
+	char _scanDelim;
+	shared_bool _closed;
+	NONE_COPY(buffered_reader);
+};
+
+/*!
+@brief tcp_socketϵĴдbuffer_poolз䣻
+СдȺϲڻУڵǰactor/generatoróstrand(next_tick)ﵽֵʱһη
+ڼдһ黺ֻ鶼ʱдҪȴֻstrandʹã
+ͬһʱֻһȴед/flush
+*/
+class buffered_writer
+{
+public:
+	typedef tcp_socket::result result;
+public:
+	/*!
+	@param strand ʹstrand
+	@param flushThreshold ݴﵽֵʱͣ0ʾ
+	*/
+	buffered_writer(const shared_strand& strand, tcp_socket& socket, const shared_buffer_pool& pool, size_t flushThreshold = 0);
+	~buffered_writer();
+public:
+	/*!
+	@brief дݣŵʱֱӷزactorл
+	*/
+	result write(my_actor* host, const void* data, size_t length);
+
+	/*!
+	@brief ȴлݷ
+	*/
+	result flush(my_actor* host);
+
+	/*!
+	@brief msʱ䷶Χڣȴлݷɣʱرsocket
+	*/
+	result timed_flush(my_actor* host, int ms, bool& overtime);
+
+	/*!
+	@brief δɵֽ
+	*/
+	size_t size() const;
+
+	/*!
+	@brief 첽ģʽ£д
+	*/
+	template <typename Handler>
+	void async_write(const void* data, size_t length, Handler&& handler)
+	{
+		assert(_strand->running_in_this_thread());
+		if (busy_waiter(handler))
+		{
+			return;
+		}
+		if (_errorCode)
+		{
+			result res = { 0, _errorCode, false };
+			handler(res);
+			return;
+		}
+		if (append(data, length))
+		{
+			result res = { length, 0, true };
+			handler(res);
+			return;
+		}
+		if (!_flushing)
+		{
+			if (_frontSize)
+			{
+				start_flush();
+			}
+			else
+			{//ֱӷ
+				_flushing = true;
+				_backSize = length;
+				_socket.async_write(data, length, _strand->wrap(std::bind([this](shared_bool& closed, Handler& handler, const result& res)
+				{
+					if (!closed)
+					{
+						flush_completed(res);
+						handler(res);
+					}
+				}, _closed, std::forward<Handler>(handler), __1)));
+				return;
+			}
+		}
+		_waiter = std::bind([this, data, length](Handler& handler)
+		{
+			async_write(data, length, std::move(handler));
+		}, std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 첽ģʽ£ȴлݷ
+	*/
+	template <typename Handler>
+	void async_flush(Handler&& handler)
+	{
+		assert(_strand->running_in_this_thread());
+		if (busy_waiter(handler))
+		{
+			return;
+		}
+		if (_errorCode || (!_flushing && !_frontSize))
+		{
+			result res = { 0, _errorCode, !_errorCode };
+			handler(res);
+			return;
+		}
+		if (!_flushing)
+		{
+			start_flush();
+		}
+		_waiter = std::bind([this](Handler& handler)
+		{
+			async_flush(std::move(handler));
+		}, std::forward<Handler>(handler));
+	}
+private:
+	/*!
+	@brief ͬһʱֻһȴед/flushеȴʱin_progressʧܣ
+	⸲ǰһȴ߻úСдԽ
+	*/
+	template <typename Handler>
+	bool busy_waiter(Handler& handler)
+	{
+		assert(!_waiter);
+		if (_waiter)
+		{
+			result res = { 0, (int)boost::asio::error::in_progress, false };
+			handler(res);
+			return true;
+		}
+		return false;
+	}
+
+	/*!
+	@brief ׷ӵǰ̨Ų·false
+	*/
+	bool append(const void* data, size_t length);
+
+	/*!
+	@brief ǰ̨ͺ̨
+	*/
+	void start_flush();
+
+	/*!
+	@brief һηɣڼ۵ݲѵȴ
+	*/
+	void flush_completed(const result& res);
+private:
+	shared_strand _strand;
+	tcp_socket& _socket;
+	buffer_slice _front;
+	buffer_slice _back;
+	size_t _frontSize;
+	size_t _backSize;
+	size_t _threshold;
+	int _errorCode;
+	bool _flushing;
+	bool _ticking;
+	std::function<void()> _waiter;
+	shared_bool _closed;
+	NONE_COPY(buffered_writer);
+};
+
+#endif
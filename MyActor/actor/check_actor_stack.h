@@ -20,6 +20,41 @@
 #endif
 #endif
 
+//Linux´Ӵа̶зֶջmmap/mprotect
+//#define ENABLE_STACK_ARENA
+
+#ifdef ENABLE_STACK_ARENA
+//С(2MB)
+#ifndef STACK_ARENA_REGION_SIZE
+#define STACK_ARENA_REGION_SIZE (64 * 1024 kB)
+#endif
+
+//ҳԣ0:ͨҳ1:͸ҳ(MADV_HUGEPAGE)2:MAP_HUGETLB(ʧ˻ͨҳرSTACK_ARENA_GUARD_PAGE1ҳλͷʱ黹ڴ)
+#ifndef STACK_ARENA_HUGE_PAGE
+#define STACK_ARENA_HUGE_PAGE 0
+#endif
+
+//ÿλײڱҳرպֻռһVMA
+#ifndef STACK_ARENA_GUARD_PAGE
+#define STACK_ARENA_GUARD_PAGE 1
+#endif
+
+//NUMAڵ
+#ifndef STACK_ARENA_MAX_NODES
+#define STACK_ARENA_MAX_NODES 8
+#endif
+#endif
+
+//LinuxÿջԤַռ䣬ֻύ貿֣ڱʱ(ENABLE_DUMP_STACK)չڱ
+//#define ENABLE_GROWABLE_STACK
+
+#ifdef ENABLE_GROWABLE_STACK
+//ÿչСߴ
+#ifndef GROWABLE_STACK_STEP
+#define GROWABLE_STACK_STEP (16 kB)
+#endif
+#endif
+
 //Ĭ϶ջ
 #ifdef WIN32
 #	if (_DEBUG || DEBUG) && (_WIN32_WINNT >= 0x0502)
@@ -99,10 +134,27 @@
 #define CHECK_LOST_ALLOC_INDEX 6
 #define CHECK_PUMP_LOST_ALLOC_INDEX 7
 #define ASIO_HANDLER_ALLOC_EX_INDEX 8
+#define STEAL_WORKER_TLS_INDEX 9
+#define CONTEXT_POOL_TLS_INDEX 10
+#define IO_ENGINE_TLS_INDEX 11
+#define SCHEDULER_STATS_TLS_INDEX 12
+#define TRACE_RING_TLS_INDEX 13
+#define EVENT_TRACE_TLS_INDEX 14
+#define CO_FUNCTION_ALLOC_INDEX 15
 
 static_assert(0 < MEM_PAGE_SIZE && MEM_PAGE_SIZE % (4 kB) == 0, "");
 static_assert(0 < MEM_POOL_LENGTH && MEM_POOL_LENGTH < 10000000, "");
 static_assert(STACK_BLOCK_SIZE >= (32 kB) && STACK_BLOCK_SIZE % MEM_PAGE_SIZE == 0, "");
+#ifdef ENABLE_STACK_ARENA
+static_assert(0 < STACK_ARENA_REGION_SIZE && STACK_ARENA_REGION_SIZE % (2 * 1024 kB) == 0, "");
+static_assert(0 < STACK_ARENA_MAX_NODES && STACK_ARENA_MAX_NODES <= 64, "");
+#endif
+#ifdef ENABLE_GROWABLE_STACK
+static_assert(0 < GROWABLE_STACK_STEP && GROWABLE_STACK_STEP % MEM_PAGE_SIZE == 0, "");
+#if (defined ENABLE_STACK_ARENA) || !(defined ENABLE_DUMP_STACK)
+#error "ENABLE_GROWABLE_STACK requires ENABLE_DUMP_STACK and conflicts with ENABLE_STACK_ARENA"
+#endif
+#endif
 
 #ifdef WIN32
 
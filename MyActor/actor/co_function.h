@@ -0,0 +1,279 @@
+#ifndef __CO_FUNCTION_H
+#define __CO_FUNCTION_H
+
+#include <type_traits>
+#include <functional>
+#include <stddef.h>
+#include <stdlib.h>
+#include "mem_pool.h"
+#include "scattered.h"
+
+//co_function洢ռ䣬ɲ񼸸/ָco_go lambda
+#ifndef CO_FUNCTION_SPACE
+#define CO_FUNCTION_SPACE (6 * sizeof(void*))
+#endif
+
+//ռĺtlsڴطĿߴ磬ֱmalloc
+#ifndef CO_FUNCTION_LARGE_SPACE
+#define CO_FUNCTION_LARGE_SPACE 256
+#endif
+
+/*!
+@brief co_functionռʱķgenerator::installװ
+*/
+struct CoFunctionAlloc_
+{
+	struct large_space
+	{
+		void* _space[CO_FUNCTION_LARGE_SPACE / sizeof(void*)];
+	};
+
+	/*!
+	@brief ڴطһlarge_spaceδװʱNULLɵ÷malloc
+	*/
+	static void* pool_allocate()
+	{
+		return _alloc ? _alloc->allocate() : NULL;
+	}
+
+	static void pool_deallocate(void* p)
+	{
+		assert(_alloc);
+		_alloc->deallocate(p);
+	}
+
+	static mem_alloc_base* _alloc;
+};
+
+template <typename Sig>
+class co_function;
+
+/*!
+@brief յstd::function/ָתΪco_function
+*/
+template <typename Handler>
+inline bool co_function_empty(const Handler&)
+{
+	return false;
+}
+
+template <typename R, typename... Args>
+inline bool co_function_empty(const std::function<R(Args...)>& h)
+{
+	return !h;
+}
+
+template <typename R, typename... Args>
+inline bool co_function_empty(R(* const& h)(Args...))
+{
+	return !h;
+}
+
+/*!
+@brief ֻƶĺСֱӴռУڴ䣻generator弰co_callջ
+*/
+template <typename R, typename... Args>
+class co_function<R(Args...)>
+{
+	struct ops
+	{
+		R(*_invoke)(void* space, Args... args);
+		void(*_move)(void* dst, void* src);
+		void(*_destroy)(void* space);
+	};
+
+	template <typename Handler>
+	struct inline_ops
+	{
+		static R invoke(void* space, Args... args)
+		{
+			return (*(Handler*)space)(std::forward<Args>(args)...);
+		}
+
+		static void move(void* dst, void* src)
+		{
+			new(dst)Handler(std::move(*(Handler*)src));
+			((Handler*)src)->~Handler();
+		}
+
+		static void destroy(void* space)
+		{
+			((Handler*)space)->~Handler();
+		}
+
+		static const ops* get()
+		{
+			static const ops s_ops = { &invoke, &move, &destroy };
+			return &s_ops;
+		}
+	};
+
+	/*!
+	@brief Դڷʱȷ(Pooled)ͷʱݵǰǷװڴ
+	*/
+	template <typename Handler, bool Pooled>
+	struct heap_ops
+	{
+		static R invoke(void* space, Args... args)
+		{
+			return (**(Handler**)space)(std::forward<Args>(args)...);
+		}
+
+		static void move(void* dst, void* src)
+		{
+			*(Handler**)dst = *(Handler**)src;
+		}
+
+		static void destroy(void* space)
+		{
+			Handler* const h = *(Handler**)space;
+			h->~Handler();
+			if (Pooled)
+			{
+				CoFunctionAlloc_::pool_deallocate(h);
+			}
+			else
+			{
+				free(h);
+			}
+		}
+
+		static const ops* get()
+		{
+			static const ops s_ops = { &invoke, &move, &destroy };
+			return &s_ops;
+		}
+	};
+
+	template <typename Handler>
+	struct is_inline
+	{
+		enum { value = sizeof(Handler) <= CO_FUNCTION_SPACE && std::alignment_of<Handler>::value <= std::alignment_of<void*>::value };
+	};
+public:
+	co_function()
+		:_ops(NULL) {}
+
+	co_function(co_function&& s)
+		:_ops(s._ops)
+	{
+		if (_ops)
+		{
+			_ops->_move(_space, s._space);
+			s._ops = NULL;
+		}
+	}
+
+	template <typename Handler, typename = typename std::enable_if<!std::is_same<typename std::decay<Handler>::type, co_function>::value>::type>
+	co_function(Handler&& handler)
+		:_ops(NULL)
+	{
+		assign(std::forward<Handler>(handler));
+	}
+
+	~co_function()
+	{
+		reset();
+	}
+
+	co_function& operator=(co_function&& s)
+	{
+		if (this != &s)
+		{
+			reset();
+			if (s._ops)
+			{
+				_ops = s._ops;
+				_ops->_move(_space, s._space);
+				s._ops = NULL;
+			}
+		}
+		return *this;
+	}
+
+	template <typename Handler, typename = typename std::enable_if<!std::is_same<typename std::decay<Handler>::type, co_function>::value>::type>
+	co_function& operator=(Handler&& handler)
+	{
+		reset();
+		assign(std::forward<Handler>(handler));
+		return *this;
+	}
+public:
+	R operator()(Args... args) const
+	{
+		assert(_ops);
+		return _ops->_invoke((void*)_space, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const
+	{
+		return !!_ops;
+	}
+
+	bool operator!() const
+	{
+		return !_ops;
+	}
+
+	void reset()
+	{
+		if (_ops)
+		{
+			const ops* const op = _ops;
+			_ops = NULL;
+			op->_destroy(_space);
+		}
+	}
+private:
+	template <typename Handler>
+	void assign(Handler&& handler)
+	{
+		typedef typename std::decay<Handler>::type handler_type;
+		if (co_function_empty(handler))
+		{
+			return;
+		}
+		assign_(std::forward<Handler>(handler), std::integral_constant<bool, is_inline<handler_type>::value>());
+	}
+
+	template <typename Handler>
+	void assign_(Handler&& handler, std::true_type)
+	{
+		typedef typename std::decay<Handler>::type handler_type;
+		new(_space)handler_type(std::forward<Handler>(handler));
+		_ops = inline_ops<handler_type>::get();
+	}
+
+	template <typename Handler>
+	void assign_(Handler&& handler, std::false_type)
+	{
+		typedef typename std::decay<Handler>::type handler_type;
+		void* const space = sizeof(handler_type) <= sizeof(CoFunctionAlloc_::large_space) && std::alignment_of<handler_type>::value <= std::alignment_of<void*>::value
+			? CoFunctionAlloc_::pool_allocate() : NULL;
+		if (space)
+		{
+			*(handler_type**)_space = new(space)handler_type(std::forward<Handler>(handler));
+			_ops = heap_ops<handler_type, true>::get();
+		}
+		else
+		{
+			*(handler_type**)_space = new(malloc(sizeof(handler_type)))handler_type(std::forward<Handler>(handler));
+			_ops = heap_ops<handler_type, false>::get();
+		}
+	}
+private:
+	const ops* _ops;
+	void* _space[(CO_FUNCTION_SPACE + sizeof(void*) - 1) / sizeof(void*)];
+	NONE_COPY(co_function);
+};
+
+/*!
+@brief co_function
+*/
+template <typename R, typename... Args>
+inline void clear_function(co_function<R(Args...)>& f)
+{
+	f.reset();
+}
+
+#endif
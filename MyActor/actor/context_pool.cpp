@@ -13,8 +13,18 @@
 #define CONTEXT_MIN_DELETE_CYCLE 300
 #endif
 
+//ÿ߳ÿֳߴ໺context
+#ifndef CONTEXT_TLS_CACHE_LENGTH
+#define CONTEXT_TLS_CACHE_LENGTH 16
+#endif
+//̻߳ȫֳ֮һcontext
+#ifndef CONTEXT_TLS_BATCH_LENGTH
+#define CONTEXT_TLS_BATCH_LENGTH (CONTEXT_TLS_CACHE_LENGTH / 2)
+#endif
+
 static_assert(1 < CONTEXT_MIN_CLEAR_CYCLE, "");
 static_assert(1 < CONTEXT_MIN_DELETE_CYCLE, "");
+static_assert(0 < CONTEXT_TLS_BATCH_LENGTH && CONTEXT_TLS_BATCH_LENGTH <= CONTEXT_TLS_CACHE_LENGTH, "");
 
 void ContextPool_::coro_push_interface::yield()
 {
@@ -32,10 +42,25 @@ DWORD ContextPool_::coro_pull_interface::_actorFlsIndex = -1;
 
 //////////////////////////////////////////////////////////////////////////
 
-std::mutex* ContextPool_::context_pool_pck::_mutex = NULL;
 ContextPool_::context_pool_pck::pool_queue::shared_node_alloc* ContextPool_::context_pool_pck::_alloc = NULL;
 //////////////////////////////////////////////////////////////////////////
 
+ContextPool_::tls_context_cache::tls_context_cache()
+{
+	memset(_head, 0, sizeof(_head));
+	memset(_count, 0, sizeof(_count));
+	_flushEpoch = _fiberPool->_flushEpoch;
+}
+
+ContextPool_::tls_context_cache::~tls_context_cache()
+{
+	for (size_t i = 0; i < 256; i++)
+	{
+		assert(0 == _count[i] && !_head[i]);
+	}
+}
+//////////////////////////////////////////////////////////////////////////
+
 ContextPool_* ContextPool_::_fiberPool = NULL;
 
 void ContextPool_::install()
@@ -45,7 +70,6 @@ void ContextPool_::install()
 #if (WIN32 && (defined CHECK_SELF) && (_WIN32_WINNT >= 0x0502))
 		ContextPool_::coro_pull_interface::_actorFlsIndex = FlsAlloc(NULL);
 #endif
-		ContextPool_::context_pool_pck::_mutex = new std::mutex;
 		ContextPool_::context_pool_pck::_alloc = new context_pool_pck::pool_queue::shared_node_alloc(MEM_POOL_LENGTH);
 		_fiberPool = new ContextPool_;
 	}
@@ -56,8 +80,6 @@ void ContextPool_::uninstall()
 	if (_fiberPool)
 	{
 		delete _fiberPool;
-		delete ContextPool_::context_pool_pck::_mutex;
-		ContextPool_::context_pool_pck::_mutex = NULL;
 		delete ContextPool_::context_pool_pck::_alloc;
 		ContextPool_::context_pool_pck::_alloc = NULL;
 #if (WIN32 && (defined CHECK_SELF) && (_WIN32_WINNT >= 0x0502))
@@ -69,7 +91,7 @@ void ContextPool_::uninstall()
 }
 
 ContextPool_::ContextPool_()
-:_exitSign(false), _clearWait(false), _stackCount(0), _stackTotalSize(0)
+:_exitSign(false), _clearWait(false), _stackCount(0), _stackTotalSize(0), _flushEpoch(0)
 {
 	run_thread th([this] { cleanThread(); });
 	_clearThread.swap(th);
@@ -91,7 +113,7 @@ ContextPool_::~ContextPool_()
 	int ic = 0;
 	for (int i = 0; i < 256; i++)
 	{
-		std::lock_guard<std::mutex> lg1(*_contextPool[i]._mutex);
+		std::lock_guard<std::mutex> lg1(_contextPool[i]._mutex);
 		while (!_contextPool[i]._pool.empty())
 		{
 			coro_pull_interface* const pull = _contextPool[i]._pool.back();
@@ -117,36 +139,186 @@ ContextPool_::~ContextPool_()
 	assert(0 == _stackTotalSize);
 }
 
+void ContextPool_::tls_init()
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	assert(tlsBuff && !tlsBuff[CONTEXT_POOL_TLS_INDEX]);
+	tlsBuff[CONTEXT_POOL_TLS_INDEX] = new tls_context_cache;
+}
+
+void ContextPool_::tls_uninit()
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	assert(tlsBuff && tlsBuff[CONTEXT_POOL_TLS_INDEX]);
+	tls_context_cache* const cache = (tls_context_cache*)tlsBuff[CONTEXT_POOL_TLS_INDEX];
+	tlsBuff[CONTEXT_POOL_TLS_INDEX] = NULL;
+	for (size_t i = 0; i < 256; i++)
+	{
+		spill(cache, i, cache->_count[i]);
+	}
+	delete cache;
+}
+
+ContextPool_::tls_context_cache* ContextPool_::tlsCache()
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	if (tlsBuff)
+	{
+		return (tls_context_cache*)tlsBuff[CONTEXT_POOL_TLS_INDEX];
+	}
+	return NULL;
+}
+
+ContextPool_::coro_pull_interface* ContextPool_::refill(tls_context_cache* cache, size_t i)
+{
+	coro_pull_interface* result = NULL;
+	const size_t batch = cache ? CONTEXT_TLS_BATCH_LENGTH : 1;
+	context_pool_pck& pool = _fiberPool->_contextPool[i];
+	std::lock_guard<std::mutex> lg(pool._mutex);
+	//ȡδڴģٴѻյﲹ
+	for (size_t n = 0; n < batch; n++)
+	{
+		coro_pull_interface* pull = NULL;
+		if (!pool._pool.empty())
+		{
+			pull = pool._pool.back();
+			pool._pool.pop_back();
+		}
+		else if (!pool._decommitPool.empty())
+		{
+			pull = pool._decommitPool.back();
+			pool._decommitPool.pop_back();
+		}
+		else
+		{
+			break;
+		}
+		if (!result)
+		{
+			result = pull;
+		}
+		else
+		{
+			pull->_cacheNext = cache->_head[i];
+			cache->_head[i] = pull;
+			cache->_count[i]++;
+		}
+	}
+	return result;
+}
+
+void ContextPool_::spill(tls_context_cache* cache, size_t i, size_t n)
+{
+	assert(n <= cache->_count[i]);
+	if (!n)
+	{
+		return;
+	}
+	//ͷ(ʹ)Ĳ֣βĹ黹ȫֳ
+	coro_pull_interface** tail = &cache->_head[i];
+	for (size_t k = cache->_count[i] - n; k; k--)
+	{
+		tail = &(*tail)->_cacheNext;
+	}
+	coro_pull_interface* pull = *tail;
+	*tail = NULL;
+	cache->_count[i] -= n;
+	giveBack(i, pull);
+}
+
+void ContextPool_::flushAged(tls_context_cache* cache)
+{
+	cache->_flushEpoch = _fiberPool->_flushEpoch;
+	const int extTick = get_tick_s();
+	for (size_t i = 0; i < 256; i++)
+	{
+		if (!cache->_head[i])
+		{
+			continue;
+		}
+		//ժóڵģȫֳ̻߳
+		coro_pull_interface* aged = NULL;
+		coro_pull_interface** agedTail = &aged;
+		coro_pull_interface** it = &cache->_head[i];
+		while (*it)
+		{
+			coro_pull_interface* const pull = *it;
+			if (extTick - pull->_tick >= CONTEXT_MIN_CLEAR_CYCLE)
+			{
+				*it = pull->_cacheNext;
+				pull->_cacheNext = NULL;
+				*agedTail = pull;
+				agedTail = &pull->_cacheNext;
+				cache->_count[i]--;
+			}
+			else
+			{
+				it = &pull->_cacheNext;
+			}
+		}
+		giveBack(i, aged);
+	}
+}
+
+void ContextPool_::giveBack(size_t i, coro_pull_interface* pull)
+{
+	if (!pull)
+	{
+		return;
+	}
+	context_pool_pck& pool = _fiberPool->_contextPool[i];
+	std::lock_guard<std::mutex> lg(pool._mutex);
+	while (pull)
+	{
+		coro_pull_interface* const next = pull->_cacheNext;
+		pull->_cacheNext = NULL;
+		//_tick룬ֶͷɣֻ߳ͷ
+		context_pool_pck::pool_queue::iterator pos = pool._pool.end();
+		while (pool._pool.begin() != pos)
+		{
+			context_pool_pck::pool_queue::iterator prev = pos;
+			if ((*--prev)->_tick <= pull->_tick)
+			{
+				break;
+			}
+			pos = prev;
+		}
+		pool._pool.insert(pos, pull);
+		pull = next;
+	}
+}
+
 ContextPool_::coro_pull_interface* ContextPool_::getContext(size_t size)
 {
 	assert(size && size % MEM_PAGE_SIZE == 0 && size <= 1024 * 1024);
 	assert(context_yield::is_thread_a_fiber());
 	size = std::max(size, (size_t)CORO_CONTEXT_STATE_SPACE);
+	tls_context_cache* const cache = tlsCache();
+	if (cache && cache->_flushEpoch != _fiberPool->_flushEpoch.load(std::memory_order_relaxed))
+	{
+		flushAged(cache);
+	}
 	do
 	{
+		const size_t i = size / MEM_PAGE_SIZE - 1;
+		if (cache && cache->_head[i])
 		{
-			context_pool_pck& pool = _fiberPool->_contextPool[size / MEM_PAGE_SIZE - 1];
-			pool._mutex->lock();
-			if (!pool._pool.empty())
-			{
-				coro_pull_interface* oldFiber = pool._pool.back();
-				pool._pool.pop_back();
-				pool._mutex->unlock();
-				oldFiber->_tick = 0;
-				return oldFiber;
-			}
-			if (!pool._decommitPool.empty())
-			{
-				coro_pull_interface* oldFiber = pool._decommitPool.back();
-				pool._decommitPool.pop_back();
-				pool._mutex->unlock();
-				oldFiber->_tick = 0;
-				return oldFiber;
-			}
-			pool._mutex->unlock();
+			coro_pull_interface* oldFiber = cache->_head[i];
+			cache->_head[i] = oldFiber->_cacheNext;
+			cache->_count[i]--;
+			oldFiber->_cacheNext = NULL;
+			oldFiber->_tick = 0;
+			return oldFiber;
+		}
+		coro_pull_interface* oldFiber = refill(cache, i);
+		if (oldFiber)
+		{
+			oldFiber->_tick = 0;
+			return oldFiber;
 		}
 		coro_pull_interface* newFiber = new coro_pull_interface;
 		newFiber->_tick = 0;
+		newFiber->_cacheNext = NULL;
 		newFiber->_coroInfo = context_yield::make_context(size, ContextPool_::contextHandler, newFiber);
 		if (newFiber->_coroInfo)
 		{
@@ -163,9 +335,53 @@ ContextPool_::coro_pull_interface* ContextPool_::getContext(size_t size)
 void ContextPool_::recovery(coro_pull_interface* pull)
 {
 	pull->_tick = get_tick_s();
-	context_pool_pck& pool = _fiberPool->_contextPool[pull->_coroInfo->stackSize / MEM_PAGE_SIZE - 1];
-	std::lock_guard<std::mutex> lg(*pool._mutex);
-	pool._pool.push_back(pull);
+	const size_t i = pull->_coroInfo->stackSize / MEM_PAGE_SIZE - 1;
+	tls_context_cache* const cache = tlsCache();
+	if (cache)
+	{
+		if (cache->_flushEpoch != _fiberPool->_flushEpoch.load(std::memory_order_relaxed))
+		{
+			flushAged(cache);
+		}
+		pull->_cacheNext = cache->_head[i];
+		cache->_head[i] = pull;
+		if (++cache->_count[i] > CONTEXT_TLS_CACHE_LENGTH)
+		{
+			spill(cache, i, CONTEXT_TLS_BATCH_LENGTH);
+		}
+	}
+	else
+	{
+		context_pool_pck& pool = _fiberPool->_contextPool[i];
+		std::lock_guard<std::mutex> lg(pool._mutex);
+		pool._pool.push_back(pull);
+	}
+}
+
+size_t ContextPool_::prewarm(size_t size, size_t n)
+{
+	assert(size && size % MEM_PAGE_SIZE == 0 && size <= 1024 * 1024);
+	assert(context_yield::is_thread_a_fiber());
+	size = std::max(size, (size_t)CORO_CONTEXT_STATE_SPACE);
+	size_t count = 0;
+	for (; count < n; count++)
+	{
+		coro_pull_interface* newFiber = new coro_pull_interface;
+		newFiber->_cacheNext = NULL;
+		newFiber->_coroInfo = context_yield::make_context(size, ContextPool_::contextHandler, newFiber);
+		if (!newFiber->_coroInfo)
+		{
+			delete newFiber;
+			break;
+		}
+		_fiberPool->_stackCount++;
+		_fiberPool->_stackTotalSize += newFiber->_coroInfo->stackSize + newFiber->_coroInfo->reserveSize;
+		newFiber->_tick = get_tick_s();
+		context_pool_pck& pool = _fiberPool->_contextPool[newFiber->_coroInfo->stackSize / MEM_PAGE_SIZE - 1];
+		std::lock_guard<std::mutex> lg(pool._mutex);
+		pool._pool.push_back(newFiber);
+	}
+	return count;
 }
 
 void ContextPool_::contextHandler(context_yield::context_info* info, void* param)
@@ -215,6 +431,8 @@ void ContextPool_::cleanThread()
 			}
 			_clearWait = false;
 		}
+		//֪̻ͨ߳´ȡ/黹ʱùõcontext
+		_flushEpoch++;
 		size_t freeCount;
 		goto _checkFree;
 		do
@@ -238,22 +456,22 @@ void ContextPool_::cleanThread()
 			for (int i = 255; i >= 0; i--)
 			{
 				context_pool_pck& contextPool = _contextPool[i];
-				contextPool._mutex->lock();
+				contextPool._mutex.lock();
 				if (!contextPool._pool.empty() && extTick - contextPool._pool.front()->_tick >= CONTEXT_MIN_CLEAR_CYCLE)
 				{
 					coro_pull_interface* const pull = contextPool._pool.front();
 					contextPool._pool.pop_front();
-					contextPool._mutex->unlock();
+					contextPool._mutex.unlock();
 					context_yield::decommit_context(pull->_coroInfo);
-					contextPool._mutex->lock();
+					contextPool._mutex.lock();
 					contextPool._decommitPool.push_front(pull);
-					contextPool._mutex->unlock();
+					contextPool._mutex.unlock();
 				}
 				else if (!contextPool._decommitPool.empty() && extTick - contextPool._decommitPool.front()->_tick >= CONTEXT_MIN_DELETE_CYCLE)
 				{
 					coro_pull_interface* const pull = contextPool._decommitPool.front();
 					contextPool._decommitPool.pop_front();
-					contextPool._mutex->unlock();
+					contextPool._mutex.unlock();
 					context_yield::context_info* const info = pull->_coroInfo;
 					freeCount++;
 					_stackCount--;
@@ -263,7 +481,7 @@ void ContextPool_::cleanThread()
 				}
 				else
 				{
-					contextPool._mutex->unlock();
+					contextPool._mutex.unlock();
 				}
 			}
 		} while (freeCount);
@@ -33,6 +33,7 @@ public:
 		coro_handler _currentHandler;
 		void* _param;
 		void* _space;
+		coro_pull_interface* _cacheNext;
 		int _tick;
 #if (_DEBUG || DEBUG)
 		size_t _spaceSize;
@@ -50,18 +51,40 @@ private:
 		:_pool(*_alloc), _decommitPool(*_alloc){}
 		pool_queue _pool;
 		pool_queue _decommitPool;
-		static std::mutex* _mutex;
+		std::mutex _mutex;
 		static pool_queue::shared_node_alloc* _alloc;
 	};
+
+	/*!
+	@brief ̱߳context棬ߴ࣬ȫֳز/黹
+	߳ÿڵ_flushEpoch߳´ȡ/黹ʱùõĽȫֳصȴ
+	*/
+	struct tls_context_cache
+	{
+		tls_context_cache();
+		~tls_context_cache();
+
+		coro_pull_interface* _head[256];
+		size_t _count[256];
+		int _flushEpoch;
+	};
 public:
 	ContextPool_();
 	~ContextPool_();
 public:
 	static coro_pull_interface* getContext(size_t size);
 	static void recovery(coro_pull_interface* coro);
+	static size_t prewarm(size_t size, size_t n);
 	static void install();
 	static void uninstall();
+	static void tls_init();
+	static void tls_uninit();
 private:
+	static tls_context_cache* tlsCache();
+	static coro_pull_interface* refill(tls_context_cache* cache, size_t i);
+	static void spill(tls_context_cache* cache, size_t i, size_t n);
+	static void flushAged(tls_context_cache* cache);
+	static void giveBack(size_t i, coro_pull_interface* pull);
 	static void contextHandler(context_yield::context_info* info, void* param);
 	void cleanThread();
 private:
@@ -73,6 +96,7 @@ private:
 	std::atomic<int> _stackCount;
 	std::condition_variable _clearVar;
 	std::atomic<size_t> _stackTotalSize;
+	std::atomic<int> _flushEpoch;
 	static ContextPool_* _fiberPool;
 };
 
@@ -9,6 +9,12 @@
 #endif
 #elif __linux__
 #include <sys/mman.h>
+#ifdef ENABLE_STACK_ARENA
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <mutex>
+#include <vector>
+#endif
 #endif
 
 namespace context_yield
@@ -149,9 +155,215 @@ struct transfer_t
 	bool convert_thread_to_fiber() {return false; }
 	bool convert_fiber_to_thread() {return false; }
 
+#ifdef ENABLE_STACK_ARENA
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#define STACK_ARENA_CLASS_NUMBER ((MAX_STACKSIZE + STACK_RESERVED_SPACE_SIZE + STACK_BLOCK_SIZE - 1) / STACK_BLOCK_SIZE)
+
+	/*!
+	@brief ջÿNUMAڵ㡢ÿֶջߴԴӴа̶зֲλ
+	λͷź黹ͷţ
+	MAP_HUGETLBĲλ޷ͨҳڱ͹黹ڴ
+	*/
+	class StackArena_
+	{
+	public:
+		struct size_class
+		{
+			std::mutex _mutex;
+			std::vector<char*> _freeSlots;
+			std::vector<char*> _freeHugeSlots;
+			char* _bumpPtr = NULL;
+			char* _bumpEnd = NULL;
+			size_t _allocSize = 0;
+			unsigned _node = 0;
+			bool _bumpHuge = false;//ǰзֵǷΪMAP_HUGETLB
+		};
+	public:
+		StackArena_()
+		{
+			for (unsigned node = 0; node < STACK_ARENA_MAX_NODES; node++)
+			{
+				for (size_t i = 0; i < STACK_ARENA_CLASS_NUMBER; i++)
+				{
+					_classes[node][i]._allocSize = (i + 1) * STACK_BLOCK_SIZE;
+					_classes[node][i]._node = node;
+				}
+			}
+		}
+
+		static StackArena_& instance()
+		{
+			static StackArena_* s_arena = new StackArena_;//֤˳ʱжջͷ
+			return *s_arena;
+		}
+
+		/*!
+		@brief ȡǰ߳ڵNUMAڵ
+		*/
+		static unsigned current_node()
+		{
+			unsigned cpu = 0, node = 0;
+			if (0 == syscall(SYS_getcpu, &cpu, &node, NULL) && node < STACK_ARENA_MAX_NODES)
+			{
+				return node;
+			}
+			return 0;
+		}
+
+		size_class* get_class(size_t allocSize)
+		{
+			assert(0 == allocSize % STACK_BLOCK_SIZE);
+			const size_t i = allocSize / STACK_BLOCK_SIZE - 1;
+			if (i < STACK_ARENA_CLASS_NUMBER)
+			{
+				return &_classes[current_node()][i];
+			}
+			return NULL;
+		}
+
+		/*!
+		@param huge زλǷλMAP_HUGETLB
+		*/
+		char* alloc(size_class* sc, bool& huge)
+		{
+			std::lock_guard<std::mutex> lg(sc->_mutex);
+			if (!sc->_freeHugeSlots.empty())
+			{//ҳλδ黹ڴ棬ȸ
+				char* const slot = sc->_freeHugeSlots.back();
+				sc->_freeHugeSlots.pop_back();
+				huge = true;
+				return slot;
+			}
+			if (!sc->_freeSlots.empty())
+			{
+				char* const slot = sc->_freeSlots.back();
+				sc->_freeSlots.pop_back();
+				huge = false;
+				return slot;
+			}
+			if (sc->_bumpPtr == sc->_bumpEnd && !new_region(sc))
+			{
+				return NULL;
+			}
+			char* const slot = sc->_bumpPtr;
+			sc->_bumpPtr += sc->_allocSize;
+			huge = sc->_bumpHuge;
+#if STACK_ARENA_GUARD_PAGE
+			assert(!huge);
+			bool ok = 0 == mprotect(slot, MEM_PAGE_SIZE, PROT_NONE);//ڱʧܣ /proc/sys/vm/max_map_count
+			assert(ok);
+#endif
+			return slot;
+		}
+
+		void free(size_class* sc, char* slot, bool huge)
+		{
+			if (huge)
+			{//ҳܰͨҳȹ黹λפ
+				std::lock_guard<std::mutex> lg(sc->_mutex);
+				sc->_freeHugeSlots.push_back(slot);
+				return;
+			}
+			//ͷڴ棬ڱҳֲ
+			madvise(slot + MEM_PAGE_SIZE, sc->_allocSize - MEM_PAGE_SIZE, MADV_DONTNEED);
+			std::lock_guard<std::mutex> lg(sc->_mutex);
+			sc->_freeSlots.push_back(slot);
+		}
+	private:
+		bool new_region(size_class* sc)
+		{
+			const size_t regionSize = STACK_ARENA_REGION_SIZE - STACK_ARENA_REGION_SIZE % sc->_allocSize;
+			void* region = MAP_FAILED;
+			sc->_bumpHuge = false;
+#if (STACK_ARENA_HUGE_PAGE == 2) && (defined MAP_HUGETLB) && !STACK_ARENA_GUARD_PAGE
+			//ҳ޷ͨҳڱڱҳʱʹMAP_HUGETLB
+			region = mmap(0, STACK_ARENA_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			sc->_bumpHuge = MAP_FAILED != region;
+#endif
+			if (MAP_FAILED == region)
+			{
+				region = mmap(0, regionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+				if (MAP_FAILED == region)
+				{
+					return false;
+				}
+#if (STACK_ARENA_HUGE_PAGE != 0) && (defined MADV_HUGEPAGE)
+				madvise(region, regionSize, MADV_HUGEPAGE);
+#endif
+			}
+			//ѡ߳ڵNUMAڵϷҳں˲֧ʱ
+			unsigned long nodeMask = 1UL << sc->_node;
+			syscall(SYS_mbind, region, regionSize, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8, 0);
+			sc->_bumpPtr = (char*)region;
+			sc->_bumpEnd = (char*)region + regionSize;
+			return true;
+		}
+	private:
+		size_class _classes[STACK_ARENA_MAX_NODES][STACK_ARENA_CLASS_NUMBER];
+	};
+
+	struct arena_context_info : public context_yield::context_info
+	{
+		StackArena_::size_class* sizeClass = NULL;
+		bool hugePage = false;
+	};
+#endif
+
+#ifdef ENABLE_GROWABLE_STACK
+	struct growable_context_info : public context_yield::context_info
+	{
+		char* commitLow = NULL;//ύĵײΪPROT_NONE
+	};
+#endif
+
 	context_yield::context_info* make_context(size_t stackSize, context_yield::context_handler handler, void* p)
 	{
 		size_t allocSize = MEM_ALIGN(stackSize + STACK_RESERVED_SPACE_SIZE, STACK_BLOCK_SIZE);
+#ifdef ENABLE_STACK_ARENA
+		StackArena_::size_class* const sizeClass = StackArena_::instance().get_class(allocSize);
+		bool hugePage = false;
+		void* stack = sizeClass ? StackArena_::instance().alloc(sizeClass, hugePage) : NULL;
+		if (!sizeClass)
+		{
+			stack = mmap(0, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (MAP_FAILED == stack)
+			{
+				return NULL;
+			}
+			bool ok = 0 == mprotect(stack, MEM_PAGE_SIZE, PROT_NONE);
+			assert(ok);
+		}
+		if (!stack)
+		{
+			return NULL;
+		}
+		arena_context_info* const arenaInfo = new arena_context_info;
+		arenaInfo->sizeClass = sizeClass;
+		arenaInfo->hugePage = hugePage;
+		context_yield::context_info* info = arenaInfo;
+		info->stackTop = (char*)stack + allocSize;
+		info->stackSize = stackSize;
+		info->reserveSize = allocSize - info->stackSize;
+#elif (defined ENABLE_GROWABLE_STACK)
+		//Ԥջַռ䣬ֻύstackSize֣Ϊڱչ
+		assert(stackSize <= MAX_STACKSIZE);
+		allocSize = MAX_STACKSIZE + STACK_RESERVED_SPACE_SIZE;
+		void* stack = mmap(0, allocSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (MAP_FAILED == stack)
+		{
+			return NULL;
+		}
+		growable_context_info* const growInfo = new growable_context_info;
+		context_yield::context_info* info = growInfo;
+		info->stackTop = (char*)stack + allocSize;
+		info->stackSize = stackSize;
+		info->reserveSize = allocSize - info->stackSize;
+		growInfo->commitLow = (char*)info->stackTop - MEM_ALIGN(stackSize, MEM_PAGE_SIZE);
+		bool ok = 0 == mprotect(growInfo->commitLow, (char*)info->stackTop - growInfo->commitLow, PROT_READ | PROT_WRITE);
+		assert(ok);
+#else
 		void* stack = mmap(0, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);//ڴ㹻¿ʧܣ /proc/sys/vm/max_map_count
 		if (!stack)
 		{
@@ -163,6 +375,7 @@ struct transfer_t
 		info->reserveSize = allocSize - info->stackSize;
 		bool ok = 0 == mprotect(stack, MEM_PAGE_SIZE, PROT_NONE);//ڱʧܣ /proc/sys/vm/max_map_count
 		assert(ok);
+#endif
 		struct local_ref
 		{
 			context_yield::context_handler handler;
@@ -211,14 +424,70 @@ struct transfer_t
 	void delete_context(context_yield::context_info* info)
 	{
 		const size_t s = info->stackSize + info->reserveSize;
+#ifdef ENABLE_STACK_ARENA
+		arena_context_info* const arenaInfo = static_cast<arena_context_info*>(info);
+		if (arenaInfo->sizeClass)
+		{
+			StackArena_::instance().free(arenaInfo->sizeClass, (char*)info->stackTop - s, arenaInfo->hugePage);
+		}
+		else
+		{
+			munmap((char*)info->stackTop - s, s);
+		}
+		delete arenaInfo;
+#elif (defined ENABLE_GROWABLE_STACK)
+		munmap((char*)info->stackTop - s, s);
+		delete static_cast<growable_context_info*>(info);
+#else
 		munmap((char*)info->stackTop - s, s);
 		delete info;
+#endif
 	}
 
 	void decommit_context(context_yield::context_info* info)
 	{
 		const size_t s = info->stackSize + info->reserveSize;
+#ifdef ENABLE_STACK_ARENA
+		if (static_cast<arena_context_info*>(info)->hugePage)
+		{//ҳλ黹ڴ
+			return;
+		}
+#endif
 		madvise((char*)info->stackTop - (s - MEM_PAGE_SIZE), s - 2 * MEM_PAGE_SIZE, MADV_DONTNEED);
+#ifdef ENABLE_GROWABLE_STACK
+		//سʼύߴ
+		growable_context_info* const growInfo = static_cast<growable_context_info*>(info);
+		char* const initLow = (char*)info->stackTop - MEM_ALIGN(info->stackSize, MEM_PAGE_SIZE);
+		if (growInfo->commitLow < initLow && 0 == mprotect(growInfo->commitLow, initLow - growInfo->commitLow, PROT_NONE))
+		{
+			growInfo->commitLow = initLow;
+		}
+#endif
+	}
+
+	bool grow_context(context_yield::context_info* info, void* faultAddr)
+	{
+#ifdef ENABLE_GROWABLE_STACK
+		//SIGSEGVеãֻʹ첽źŰȫ
+		growable_context_info* const growInfo = static_cast<growable_context_info*>(info);
+		char* const sb = (char*)info->stackTop - info->stackSize - info->reserveSize;
+		char* const violationAddr = (char*)((size_t)faultAddr & (0 - MEM_PAGE_SIZE));
+		if (violationAddr < sb + MEM_PAGE_SIZE || violationAddr >= growInfo->commitLow)
+		{
+			return false;
+		}
+		char* newLow = growInfo->commitLow - GROWABLE_STACK_STEP;
+		newLow = violationAddr < newLow ? violationAddr : newLow;
+		newLow = newLow < sb + MEM_PAGE_SIZE ? sb + MEM_PAGE_SIZE : newLow;//ײһҳʼΪڱ
+		if (0 != mprotect(newLow, growInfo->commitLow - newLow, PROT_READ | PROT_WRITE))
+		{
+			return false;
+		}
+		growInfo->commitLow = newLow;
+		return true;
+#else
+		return false;
+#endif
 	}
 #endif
 }
\ No newline at end of file
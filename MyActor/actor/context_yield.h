@@ -22,6 +22,9 @@ namespace context_yield
 	void pull_yield(context_info* info);
 	void delete_context(context_info* info);
 	void decommit_context(context_info* info);
+#ifdef __linux__
+	bool grow_context(context_info* info, void* faultAddr);
+#endif
 }
 
 #endif
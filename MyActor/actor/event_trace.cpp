@@ -0,0 +1,231 @@
+#include "event_trace.h"
+
+#ifdef ENABLE_EVENT_TRACE
+#include "io_engine.h"
+#include "scattered.h"
+#include "check_actor_stack.h"
+#include <stdio.h>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+/*!
+@brief һ׷ټ¼
+*/
+struct EventRecord_
+{
+	long long _tick;
+	unsigned long long _id;
+	event_trace_type _type;
+};
+
+/*!
+@brief ߼¼д󸲸ɵļ¼
+*/
+struct EventBuffer_
+{
+	EventBuffer_(size_t capacity, unsigned tid)
+		:_records(new EventRecord_[capacity]), _mask(capacity - 1), _count(0), _tid(tid), _retired(false) {}
+
+	~EventBuffer_()
+	{
+		delete[] _records;
+	}
+
+	void push(event_trace_type type, unsigned long long id)
+	{
+		const size_t n = _count.load(std::memory_order_relaxed);
+		EventRecord_& rec = _records[n & _mask];
+		rec._tick = get_tick_ns();
+		rec._id = id;
+		rec._type = type;
+		_count.store(n + 1, std::memory_order_release);
+	}
+
+	EventRecord_* const _records;
+	const size_t _mask;
+	std::atomic<size_t> _count;
+	const unsigned _tid;
+	bool _retired;
+};
+
+struct EventTraceRegistry_
+{
+	EventTraceRegistry_()
+		:_capacity(0), _shared(NULL), _tidCount(0) {}
+
+	std::mutex _mutex;
+	std::vector<EventBuffer_*> _buffers;
+	size_t _capacity;
+	EventBuffer_* _shared;//io_engine̹߳ã_sharedMutex
+	std::mutex _sharedMutex;
+	unsigned _tidCount;
+};
+
+static EventTraceRegistry_ s_eventTrace;
+std::atomic<bool> event_trace::_enabled(false);
+
+static const char* const s_eventNames[et_type_count] =
+{
+	"actor_create",
+	"actor_run",
+	"actor",
+	"actor",
+	"actor_quit",
+	"generator",
+	"generator",
+	"strand_post",
+	"strand_dispatch",
+	"strand_tick",
+	"chan_push",
+	"chan_pop",
+	"chan_wait",
+	"timer_arm",
+	"timer_fire",
+	"mutex_lock",
+	"mutex_wait",
+	"mutex_unlock",
+};
+
+/*!
+@brief Chrome trace¼׶ΣB/EɶԱʾһִУiΪ˲ʱ¼
+*/
+static char event_phase(event_trace_type type)
+{
+	switch (type)
+	{
+	case et_actor_resume: case et_generator_enter: return 'B';
+	case et_actor_yield: case et_generator_leave: return 'E';
+	default: return 'i';
+	}
+}
+
+static EventBuffer_* new_event_buffer()
+{
+	std::lock_guard<std::mutex> lg(s_eventTrace._mutex);
+	EventBuffer_* buff = new EventBuffer_(s_eventTrace._capacity, ++s_eventTrace._tidCount);
+	s_eventTrace._buffers.push_back(buff);
+	return buff;
+}
+
+void event_trace::_record(event_trace_type type, unsigned long long id)
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	if (tlsBuff)
+	{
+		EventBuffer_*& buff = (EventBuffer_*&)tlsBuff[EVENT_TRACE_TLS_INDEX];
+		if (!buff)
+		{
+			buff = new_event_buffer();
+		}
+		buff->push(type, id);
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lg(s_eventTrace._sharedMutex);
+		if (!s_eventTrace._shared)
+		{
+			s_eventTrace._shared = new_event_buffer();
+		}
+		s_eventTrace._shared->push(type, id);
+	}
+}
+
+void event_trace::tls_uninit()
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	if (tlsBuff && tlsBuff[EVENT_TRACE_TLS_INDEX])
+	{
+		std::lock_guard<std::mutex> lg(s_eventTrace._mutex);
+		((EventBuffer_*)tlsBuff[EVENT_TRACE_TLS_INDEX])->_retired = true;
+		tlsBuff[EVENT_TRACE_TLS_INDEX] = NULL;
+	}
+}
+
+void event_trace::start(size_t capacity)
+{
+	assert(capacity && 0 == (capacity & (capacity - 1)));
+	if (_enabled.load())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lg(s_eventTrace._mutex);
+		s_eventTrace._capacity = capacity;
+		for (size_t i = 0; i < s_eventTrace._buffers.size();)
+		{
+			EventBuffer_* const buff = s_eventTrace._buffers[i];
+			if (buff->_retired)
+			{//߳˳д
+				s_eventTrace._buffers.erase(s_eventTrace._buffers.begin() + i);
+				delete buff;
+			}
+			else
+			{
+				buff->_count.store(0, std::memory_order_relaxed);
+				i++;
+			}
+		}
+	}
+	_enabled.store(true);
+}
+
+void event_trace::stop()
+{
+	_enabled.store(false);
+}
+
+bool event_trace::dump(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		return false;
+	}
+	std::lock_guard<std::mutex> lg(s_eventTrace._mutex);
+	std::vector<EventRecord_> records;
+	bool first = true;
+	fprintf(file, "{\"traceEvents\":[\n");
+	for (EventBuffer_* buff : s_eventTrace._buffers)
+	{
+		const size_t capacity = buff->_mask + 1;
+		const size_t end = buff->_count.load(std::memory_order_acquire);
+		size_t begin = end > capacity ? end - capacity : 0;
+		records.assign(buff->_records, buff->_records + std::min(end, capacity));
+		//¼ڼ䱻ǵĲֶ
+		const size_t after = buff->_count.load(std::memory_order_acquire);
+		if (after > capacity && after - capacity > begin)
+		{
+			begin = after - capacity;
+		}
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+			first ? "" : ",\n", buff->_tid, buff == s_eventTrace._shared ? "shared" : "io_engine", buff->_tid);
+		first = false;
+		size_t depth = 0;
+		for (size_t i = begin; i < end; i++)
+		{
+			const EventRecord_& rec = records[i & buff->_mask];
+			const char ph = event_phase(rec._type);
+			if ('E' == ph)
+			{
+				if (!depth)
+				{//ʼ¼ѱ
+					continue;
+				}
+				depth--;
+			}
+			else if ('B' == ph)
+			{
+				depth++;
+			}
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",%s\"ts\":%lld.%03d,\"pid\":1,\"tid\":%u,\"args\":{\"id\":%llu}}",
+				s_eventNames[rec._type], ph, 'i' == ph ? "\"s\":\"t\"," : "", rec._tick / 1000, (int)(rec._tick % 1000), buff->_tid, rec._id);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	const bool ok = !ferror(file);
+	fclose(file);
+	return ok;
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef __EVENT_TRACE_H
+#define __EVENT_TRACE_H
+
+//actor/generatorڼ¼Ķ׷٣ʱκο
+//#define ENABLE_EVENT_TRACE
+
+#ifdef ENABLE_EVENT_TRACE
+#include <atomic>
+#include <stddef.h>
+
+/*!
+@brief ׷¼
+*/
+enum event_trace_type
+{
+	et_actor_create,
+	et_actor_run,
+	et_actor_resume,//actorʼһ(pull_yield)
+	et_actor_yield,//actoró(push_yield)
+	et_actor_quit,
+	et_generator_enter,//generatorʼִһ(_next)
+	et_generator_leave,
+	et_strand_post,
+	et_strand_dispatch,
+	et_strand_tick,
+	et_chan_push,
+	et_chan_pop,
+	et_chan_wait,
+	et_timer_arm,
+	et_timer_fire,
+	et_mutex_lock,
+	et_mutex_wait,
+	et_mutex_unlock,
+	et_type_count
+};
+
+/*!
+@brief ¼׷٣ÿio_engine߳дԼĶ¼(ֻµļ¼)io_engine̹߳һļ¼
+stopdumpΪChrome trace/PerfettoɼصJSON
+*/
+class event_trace
+{
+public:
+	/*!
+	@brief ʼ¼֮ǰļ¼
+	@param capacity ÿ߳ౣļ¼(2)ֻӰ֮½̼߳¼
+	*/
+	static void start(size_t capacity = 64 * 1024);
+
+	/*!
+	@brief ֹͣ¼
+	*/
+	static void stop();
+
+	/*!
+	@brief ΪChrome trace JSON
+	*/
+	static bool dump(const char* path);
+
+	/*!
+	@brief ¼һ¼
+	@param id actorΪself_id()Ϊַ
+	*/
+	static void record(event_trace_type type, unsigned long long id)
+	{
+		if (_enabled.load(std::memory_order_relaxed))
+		{
+			_record(type, id);
+		}
+	}
+
+	/*!
+	@brief io_engine߳˳ʱ¼
+	*/
+	static void tls_uninit();
+private:
+	static void _record(event_trace_type type, unsigned long long id);
+private:
+	static std::atomic<bool> _enabled;
+};
+
+/*!
+@brief ڼ¼һִУ뿪ʱ¼¼
+*/
+struct EventTraceScope_
+{
+	EventTraceScope_(event_trace_type enter, event_trace_type leave, unsigned long long id)
+		:_leave(leave), _id(id)
+	{
+		event_trace::record(enter, id);
+	}
+
+	~EventTraceScope_()
+	{
+		event_trace::record(_leave, _id);
+	}
+
+	const event_trace_type _leave;
+	const unsigned long long _id;
+};
+
+#define EVENT_TRACE(__type__, __id__) event_trace::record(__type__, (unsigned long long)(__id__))
+#define EVENT_TRACE_SCOPE(__enter__, __leave__, __id__) EventTraceScope_ __eventTraceScope(__enter__, __leave__, (unsigned long long)(__id__))
+#else
+#define EVENT_TRACE(__type__, __id__)
+#define EVENT_TRACE_SCOPE(__enter__, __leave__, __id__)
+#endif
+
+#endif
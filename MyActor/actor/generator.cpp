@@ -1,34 +1,40 @@
 #include "generator.h"
 
 mem_alloc_base* generator::_genObjAlloc = NULL;
+mem_alloc_base* CoFunctionAlloc_::_alloc = NULL;
 std::atomic<long long>* generator::_id = NULL;
 any_accept generator::__anyAccept;
 
 void generator::install(std::atomic<long long>* id)
 {
 	_genObjAlloc = make_shared_space_alloc<generator, mem_alloc_tls<GENERATOR_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](generator*){});
+	CoFunctionAlloc_::_alloc = new mem_alloc_tls<CO_FUNCTION_ALLOC_INDEX, CoFunctionAlloc_::large_space>(MEM_POOL_LENGTH);
 	_id = id;
 }
 
 void generator::uninstall()
 {
 	delete _genObjAlloc;
+	delete CoFunctionAlloc_::_alloc;
 	_genObjAlloc = NULL;
+	CoFunctionAlloc_::_alloc = NULL;
 	_id = NULL;
 }
 
 void generator::tls_init()
 {
 	_genObjAlloc->tls_init();
+	CoFunctionAlloc_::_alloc->tls_init();
 }
 
 void generator::tls_uninit()
 {
 	_genObjAlloc->tls_uninit();
+	CoFunctionAlloc_::_alloc->tls_uninit();
 }
 
 generator::generator()
-: __ctx(NULL), __coNext(0), __coNextEx(0), __lockStop(0), __readyQuit(false), __asyncSign(false), __yieldSign(false)
+: _ctxSpaceUsed(false), _pool(NULL), _poolPrev(NULL), _poolNext(NULL), __ctx(NULL), __coNext(0), __coNextEx(0), __lockStop(0), __readyQuit(false), __asyncSign(false), __yieldSign(false)
 #if (_DEBUG || DEBUG)
 , _isRun(false), __inside(false), __awaitSign(false), __sharedAwaitSign(false)
 #endif
@@ -38,12 +44,14 @@ generator::generator()
 generator::~generator()
 {
 	assert(!__ctx);
+	assert(!_ctxSpaceUsed);
 	assert(_callStack.empty());
 }
 
 bool generator::_next()
 {
 	assert(_strand->running_in_this_thread());
+	EVENT_TRACE_SCOPE(et_generator_enter, et_generator_leave, this);
 	assert(_baseHandler);
 	assert(!__ctx || !__inside);
 	DEBUG_OPERATION(if (__ctx) __inside = true);
@@ -63,9 +71,16 @@ bool generator::_next()
 			clear_function(_baseHandler);
 			if (_notify)
 			{
-				CHECK_EXCEPTION(std::function<void()>(std::move(_notify)));
+				CHECK_EXCEPTION(co_function<void()>(std::move(_notify)));
+			}
+			if (_pool)
+			{
+				_pool->_recycle(this);
+			}
+			else
+			{
+				_sharedThis.reset();
 			}
-			_sharedThis.reset();
 			return true;
 		}
 		call_stack_pck& topStack = _callStack.front();
@@ -93,7 +108,7 @@ bool generator::_next()
 	return false;
 }
 
-generator_handle generator::create(shared_strand strand, std::function<void(generator&)> handler, std::function<void()> notify)
+generator_handle generator::create(shared_strand strand, co_function<void(generator&)> handler, co_function<void()> notify)
 {
 	void* space = _genObjAlloc->allocate();
 	generator_handle res(new(space)generator(), [](generator* p)
@@ -337,7 +352,7 @@ void generator::_co_shared_async_next(shared_bool& sign)
 	}
 }
 
-void generator::_co_push_stack(int coNext, std::function<void(generator&)>&& handler)
+void generator::_co_push_stack(int coNext, co_function<void(generator&)>&& handler)
 {
 	_callStack.push_front(call_stack_pck(coNext, __coNextEx, __ctx, std::move(handler)));
 }
@@ -378,4 +393,119 @@ void generator::timeout_handler()
 	assert(__ctx);
 	_timerHandle.reset();
 	_next();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+generator_pool::generator_pool(const shared_strand& strand, size_t poolSize)
+:_strand(strand), _runningHead(NULL), _poolSize(poolSize), _running(0)
+{
+	_freeList.reserve(poolSize);
+}
+
+generator_pool::~generator_pool()
+{
+	assert(!_strand->in_this_ios() || _strand->running_in_this_thread());
+	//еgeneratorأʱٻ
+	generator* gen = _runningHead;
+	while (gen)
+	{
+		generator* const next = gen->_poolNext;
+		gen->_pool = NULL;
+		gen->_poolPrev = gen->_poolNext = NULL;
+		gen = next;
+	}
+	_runningHead = NULL;
+	_running = 0;
+}
+
+void generator_pool::launch(co_function<void(generator&)> handler, co_function<void()> notify)
+{
+	assert(_strand->running_in_this_thread());
+	generator_handle gen;
+	if (!_freeList.empty())
+	{
+		gen = std::move(_freeList.back());
+		_freeList.pop_back();
+	}
+	else
+	{
+		gen = generator::create(_strand, co_function<void(generator&)>());
+	}
+	generator* const gen_ = gen.get();
+	assert(!gen_->__ctx && gen_->_callStack.empty() && !gen_->_ctxSpaceUsed);
+	gen_->__coNext = 0;
+	gen_->__coNextEx = 0;
+	gen_->__lockStop = 0;
+	gen_->__readyQuit = false;
+	gen_->__asyncSign = false;
+	gen_->__yieldSign = false;
+	DEBUG_OPERATION(gen_->_isRun = true);
+	gen_->_pool = this;
+	gen_->_baseHandler = std::move(handler);
+	gen_->_notify = std::move(notify);
+	gen_->_sharedThis = std::move(gen);
+	gen_->_poolPrev = NULL;
+	gen_->_poolNext = _runningHead;
+	if (_runningHead)
+	{
+		_runningHead->_poolPrev = gen_;
+	}
+	_runningHead = gen_;
+	_running++;
+	gen_->_next();
+}
+
+void generator_pool::reserve(size_t n)
+{
+	while (_freeList.size() < n && _freeList.size() < _poolSize)
+	{
+		_freeList.push_back(generator::create(_strand, co_function<void(generator&)>()));
+	}
+}
+
+size_t generator_pool::size()
+{
+	return _freeList.size();
+}
+
+size_t generator_pool::running()
+{
+	return _running;
+}
+
+const shared_strand& generator_pool::self_strand()
+{
+	return _strand;
+}
+
+void generator_pool::_recycle(generator* gen)
+{
+	assert(_strand->running_in_this_thread());
+	assert(_running);
+	_running--;
+	if (gen->_poolPrev)
+	{
+		gen->_poolPrev->_poolNext = gen->_poolNext;
+	}
+	else
+	{
+		assert(_runningHead == gen);
+		_runningHead = gen->_poolNext;
+	}
+	if (gen->_poolNext)
+	{
+		gen->_poolNext->_poolPrev = gen->_poolPrev;
+	}
+	gen->_poolPrev = gen->_poolNext = NULL;
+	DEBUG_OPERATION(gen->_isRun = false);
+	if (gen->_sharedThis && 1 == gen->_sharedThis.use_count() && _freeList.size() < _poolSize)
+	{
+		_freeList.push_back(std::move(gen->_sharedThis));
+	}
+	else
+	{//Ա첽صУúɻصµĺ
+		gen->_pool = NULL;
+		gen->_sharedThis.reset();
+	}
 }
\ No newline at end of file
@@ -1,9 +1,16 @@
 #ifndef __GENERATOR_H
 #define __GENERATOR_H
 
+#include <vector>
 #include "msg_queue.h"
 #include "actor_timer.h"
 #include "async_timer.h"
+#include "co_function.h"
+
+//generatorĿռ䣬co_end_context/co_end_context_initĲóߴʱٵڴ
+#ifndef GENERATOR_CONTEXT_SPACE
+#define GENERATOR_CONTEXT_SPACE (12 * sizeof(void*))
+#endif
 
 //generatorڣȡǰgenerator
 #define co_self __co_self
@@ -74,7 +81,7 @@ struct __co_context_no_capture{};
 	auto __stop = [&co_self]{\
 	DEBUG_OPERATION(co_self.__inside = false);\
 	struct co_context_tag* const pCtx = static_cast<struct co_context_tag*>(co_self.__ctx);\
-	if((void*)-1!=(void*)pCtx){delete pCtx;}\
+	if((void*)-1!=(void*)pCtx){co_self._delete_context(pCtx);}\
 	co_self.__ctx = NULL;}
 
 #define _co_stop_dealloc(__dealloc__) \
@@ -92,7 +99,7 @@ struct __co_context_no_capture{};
 
 //generatorĶ
 #define co_end_context(__ctx__) };\
-	if (!co_self.__ctx){co_self._lockThis(); co_self.__ctx = -1==co_self.__coNext ? (void*)-1 : new co_context_tag();\
+	if (!co_self.__ctx){co_self._lockThis(); co_self.__ctx = -1==co_self.__coNext ? (void*)-1 : co_self._new_context<co_context_tag>();\
 	_co_end_context(__ctx__); _co_stop(); if(0){
 
 #define _cop(__p__) decltype(__p__)& __p__
@@ -111,7 +118,7 @@ struct __co_context_no_capture{};
 
 //generatorĶ壬ڲʼ
 #define co_end_context_init(__ctx__, __capture__, ...) _co_capture __capture__:__VA_ARGS__{}};\
-	if (!co_self.__ctx){co_self._lockThis(); co_self.__ctx = -1==co_self.__coNext ? (void*)-1 : new co_context_tag __capture__;\
+	if (!co_self.__ctx){co_self._lockThis(); co_self.__ctx = -1==co_self.__coNext ? (void*)-1 : co_self._new_context<co_context_tag>__capture__;\
 	_co_end_context(__ctx__); _co_stop(); if(0){
 
 //generatorʱ״̬Բ
@@ -357,6 +364,8 @@ struct __co_context_no_capture{};
 #define co_go(...) CoGo_(__VA_ARGS__)-
 //һgenerator
 #define co_create(...) CoCreate_(__VA_ARGS__)-
+//generator_poolȡһgenerator
+#define co_pool_go(...) CoPoolGo_(__VA_ARGS__)-
 //ǰgenerator
 #define co_stop do{__stop(); return;} while(0)
 //ⲿgeneratorstop
@@ -459,6 +468,8 @@ struct __co_context_no_capture{};
 #define co_chan_aff_timed_push(__chan__, __ms__, ...) do{(__chan__).aff_timed_push(co_timer, __ms__, co_async_result(co_last_state), __VA_ARGS__); _co_await;}while (0)
 #define co_chan_aff_timed_copy_push(__chan__, __ms__, ...) do{(__chan__).aff_timed_push(co_timer, __ms__, co_async_result(co_last_state), forward_copys(__VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_timed_push_void(__chan__, __ms__) do{(__chan__).aff_timed_push(co_timer, __ms__, co_async_result(co_last_state)); _co_await;}while (0)
+//ͬһstrandʱȳԿpushδʱֱд룩첽push
+#define co_chan_aff_fast_push(__chan__, ...) do{if ((__chan__).aff_fast_push(__VA_ARGS__)) co_last_state = co_async_state::co_async_ok; else co_chan_aff_push(__chan__, __VA_ARGS__);}while (0)
 #define co_csp_aff_push(__chan__, __res__, ...) do{(__chan__).aff_push(co_async_result_(co_last_state, __res__), __VA_ARGS__); _co_await;}while (0)
 #define co_csp_aff_copy_push(__chan__, __res__, ...) do{(__chan__).aff_push(co_async_result_(co_last_state, __res__), forward_copys(__VA_ARGS__)); _co_await;}while (0)
 #define co_csp_aff_push_void(__chan__, __res__) do{(__chan__).aff_push(co_async_result_(co_last_state, __res__)); _co_await;}while (0)
@@ -497,6 +508,8 @@ struct __co_context_no_capture{};
 #define co_chan_aff_timed_pop(__chan__, __ms__, ...) do{(__chan__).aff_timed_pop(co_timer, __ms__, co_async_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_timed_safe_pop(__chan__, __ms__, ...) do{(__chan__).aff_timed_pop(co_timer, __ms__, co_async_safe_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_timed_pop_void(__chan__, __ms__) do{(__chan__).aff_timed_pop(co_timer, __ms__, co_async_result_(co_last_state)); _co_await;}while (0)
+//ͬһstrandʱȳԿpopǿʱֱȡ첽pop
+#define co_chan_aff_fast_pop(__chan__, ...) do{if ((__chan__).aff_fast_pop(__VA_ARGS__)) co_last_state = co_async_state::co_async_ok; else co_chan_aff_pop(__chan__, __VA_ARGS__);}while (0)
 //һchannelжȡһתӵһchannel
 #define co_chan_relay(__src_chan__, __dst_chan__) do{(__src_chan__).pop(CoChanRelay_<decltype(__dst_chan__)>(std::move(co_async_this), co_last_state, __dst_chan__)); _co_await;}while (0)
 #define co_chan_try_relay(__src_chan__, __dst_chan__) do{(__src_chan__).try_pop(CoChanTryRelay_<decltype(__dst_chan__)>(std::move(co_async_this), co_last_state, __dst_chan__)); _co_await;}while (0)
@@ -997,10 +1010,11 @@ struct __co_context_no_capture{};
 #define co_calc CoLocalWrapCalc_()*[&]
 #define co_calc_of CoLocalWrapCalc_()*
 //generator function
-#define co_func_type std::function<void(generator&)>
+#define co_func_type co_function<void(generator&)>
 
 class my_actor;
 class generator;
+class generator_pool;
 typedef std::shared_ptr<generator> generator_handle;
 
 /*!
@@ -1010,12 +1024,13 @@ class generator : public ActorTimerFace_
 {
 	friend my_actor;
 	friend io_engine;
+	friend generator_pool;
 	FRIEND_SHARED_PTR(generator);
 	struct call_stack_pck
 	{
-		call_stack_pck(int coNext, int coNextEx, void* ctx, std::function<void(generator&)>&& handler)
+		call_stack_pck(int coNext, int coNextEx, void* ctx, co_function<void(generator&)>&& handler)
 		:_handler(std::move(handler)), _ctx(ctx), _coNext(coNext), _coNextEx(coNextEx)  {}
-		std::function<void(generator&)> _handler;
+		co_function<void(generator&)> _handler;
 		void* _ctx;
 		int _coNext;
 		int _coNextEx;
@@ -1025,7 +1040,7 @@ private:
 	generator();
 	~generator();
 public:
-	static generator_handle create(shared_strand strand, std::function<void(generator&)> handler, std::function<void()> notify = std::function<void()>());
+	static generator_handle create(shared_strand strand, co_function<void(generator&)> handler, co_function<void()> notify = co_function<void()>());
 	void run();
 	void stop();
 	const shared_strand& self_strand();
@@ -1083,7 +1098,48 @@ public:
 	void _co_usleep(long long us);
 	void _co_dead_sleep(long long ms);
 	void _co_dead_usleep(long long us);
-	void _co_push_stack(int coNext, std::function<void(generator&)>&& handler);
+	void _co_push_stack(int coNext, co_function<void(generator&)>&& handler);
+
+	/*!
+	@brief 캯ģߴڱȷռŵδռ(co_callջϲ)ʱֱӹgenerator
+	*/
+	template <typename Ctx, typename... Args>
+	Ctx* _new_context(Args&&... args)
+	{
+		return _new_context_<Ctx>(std::integral_constant<bool, sizeof(Ctx) <= sizeof(_ctxSpace) && std::alignment_of<Ctx>::value <= std::alignment_of<void*>::value>(), std::forward<Args>(args)...);
+	}
+
+	template <typename Ctx>
+	void _delete_context(Ctx* ctx)
+	{
+		if ((void*)ctx == (void*)_ctxSpace)
+		{
+			ctx->~Ctx();
+			_ctxSpaceUsed = false;
+		}
+		else
+		{
+			delete ctx;
+		}
+	}
+private:
+	template <typename Ctx, typename... Args>
+	Ctx* _new_context_(std::true_type, Args&&... args)
+	{
+		if (!_ctxSpaceUsed)
+		{
+			Ctx* const ctx = new(_ctxSpace)Ctx(std::forward<Args>(args)...);
+			_ctxSpaceUsed = true;
+			return ctx;
+		}
+		return new Ctx(std::forward<Args>(args)...);
+	}
+
+	template <typename Ctx, typename... Args>
+	Ctx* _new_context_(std::false_type, Args&&... args)
+	{
+		return new Ctx(std::forward<Args>(args)...);
+	}
 private:
 	void timeout_handler();
 	static void install(std::atomic<long long>* id);
@@ -1093,12 +1149,17 @@ private:
 private:
 	std::weak_ptr<generator> _weakThis;
 	std::shared_ptr<generator> _sharedThis;
-	std::function<void(generator&)> _baseHandler;
-	std::function<void()> _notify;
+	co_function<void(generator&)> _baseHandler;
+	co_function<void()> _notify;
 	msg_queue<call_stack_pck> _callStack;
 	shared_strand _strand;
 	ActorTimer_::timer_handle _timerHandle;
 	shared_bool _sharedSign;
+	void* _ctxSpace[(GENERATOR_CONTEXT_SPACE + sizeof(void*) - 1) / sizeof(void*)];
+	bool _ctxSpaceUsed;
+	generator_pool* _pool;
+	generator* _poolPrev;
+	generator* _poolNext;
 	DEBUG_OPERATION(bool _isRun);
 	static mem_alloc_base* _genObjAlloc;
 	static std::atomic<long long>* _id;
@@ -1119,6 +1180,54 @@ public:
 	NONE_COPY(generator);
 };
 
+/*!
+@brief һstrandϵgeneratorأgeneratorͬshared_ptrƿյУ
+ٴʱ״ֱ̬Ӹãڴ䣬ҲüԭӲֻstrandʹã
+generatorⱩ¶ʱԱ첽صеgeneratorգ
+ʱеgeneratorأͷ(strandлstrandֹͣ)
+*/
+class generator_pool
+{
+	friend generator;
+public:
+	/*!
+	@param poolSize ౣĿgenerator
+	*/
+	generator_pool(const shared_strand& strand, size_t poolSize = 1024);
+	~generator_pool();
+public:
+	/*!
+	@brief ȡһgenerator(û½)handlerΪ
+	*/
+	void launch(co_function<void(generator&)> handler, co_function<void()> notify = co_function<void()>());
+
+	/*!
+	@brief Ԥȴngenerator
+	*/
+	void reserve(size_t n);
+
+	/*!
+	@brief generator
+	*/
+	size_t size();
+
+	/*!
+	@brief еgenerator
+	*/
+	size_t running();
+
+	const shared_strand& self_strand();
+private:
+	void _recycle(generator* gen);
+private:
+	shared_strand _strand;
+	std::vector<generator_handle> _freeList;
+	generator* _runningHead;
+	size_t _poolSize;
+	size_t _running;
+	NONE_COPY(generator_pool);
+};
+
 enum co_async_state : char
 {
 	co_async_undefined = (char)-1,
@@ -1142,10 +1251,10 @@ private:
 
 struct CoGo_
 {
-	CoGo_(shared_strand strand, std::function<void()> ntf = std::function<void()>())
+	CoGo_(shared_strand strand, co_function<void()> ntf = co_function<void()>())
 		:_strand(std::move(strand)), _ntf(std::move(ntf)) {}
 
-	CoGo_(io_engine& ios, std::function<void()> ntf = std::function<void()>())
+	CoGo_(io_engine& ios, co_function<void()> ntf = co_function<void()>())
 		:_strand(boost_strand::create(ios)), _ntf(std::move(ntf)) {}
 
 	template <typename Handler>
@@ -1157,15 +1266,30 @@ struct CoGo_
 	}
 
 	shared_strand _strand;
-	std::function<void()> _ntf;
+	co_function<void()> _ntf;
+};
+
+struct CoPoolGo_
+{
+	CoPoolGo_(generator_pool& pool, co_function<void()> ntf = co_function<void()>())
+		:_pool(pool), _ntf(std::move(ntf)) {}
+
+	template <typename Handler>
+	void operator-(Handler&& handler)
+	{
+		_pool.launch(std::forward<Handler>(handler), std::move(_ntf));
+	}
+
+	generator_pool& _pool;
+	co_function<void()> _ntf;
 };
 
 struct CoCreate_
 {
-	CoCreate_(shared_strand strand, std::function<void()> ntf = std::function<void()>())
+	CoCreate_(shared_strand strand, co_function<void()> ntf = co_function<void()>())
 	:_strand(std::move(strand)), _ntf(std::move(ntf)) {}
 
-	CoCreate_(io_engine& ios, std::function<void()> ntf = std::function<void()>())
+	CoCreate_(io_engine& ios, co_function<void()> ntf = co_function<void()>())
 		:_strand(boost_strand::create(ios)), _ntf(std::move(ntf)) {}
 
 	template <typename Handler>
@@ -1175,7 +1299,7 @@ struct CoCreate_
 	}
 
 	shared_strand _strand;
-	std::function<void()> _ntf;
+	co_function<void()> _ntf;
 };
 
 struct CoTimeout_
@@ -1885,13 +2009,13 @@ template <bool>
 struct CoCallBind_
 {
 	template <typename Handler, typename... Args>
-	static std::function<void(generator&)> bind(Handler&& handler, Args&&... args)
+	static co_function<void(generator&)> bind(Handler&& handler, Args&&... args)
 	{
 		return std::bind(std::forward<Handler>(handler), __1, std::forward<Args>(args)...);
 	}
 
 	template <typename Handler>
-	static std::function<void(generator&)> bind(Handler&& handler)
+	static co_function<void(generator&)> bind(Handler&& handler)
 	{
 		return std::forward<Handler>(handler);
 	}
@@ -1901,20 +2025,20 @@ template <>
 struct CoCallBind_<true>
 {
 	template <typename Func, typename Obj, typename... Args>
-	static std::function<void(generator&)> bind(Func func, Obj&& obj, Args&&... args)
+	static co_function<void(generator&)> bind(Func func, Obj&& obj, Args&&... args)
 	{
 		return std::bind(func, std::forward<Obj>(obj), __1, std::forward<Args>(args)...);
 	}
 };
 
 template <typename Handler, typename Unknown, typename... Args>
-static std::function<void(generator&)> _co_call_bind(Handler&& handler, Unknown&& unkown, Args&&... args)
+static co_function<void(generator&)> _co_call_bind(Handler&& handler, Unknown&& unkown, Args&&... args)
 {
 	return CoCallBind_<CheckClassFunc_<RM_REF(Handler)>::value>::bind(std::forward<Handler>(handler), std::forward<Unknown>(unkown), std::forward<Args>(args)...);
 }
 
 template <typename Handler>
-static std::function<void(generator&)> _co_call_bind(Handler&& handler)
+static co_function<void(generator&)> _co_call_bind(Handler&& handler)
 {
 	static_assert(!CheckClassFunc_<RM_REF(Handler)>::value, "");
 	return CoCallBind_<false>::bind(std::forward<Handler>(handler));
@@ -2592,6 +2716,10 @@ class co_msg_buffer;
 template <typename... Types>
 class co_channel;
 template <typename... Types>
+class co_ring_channel;
+template <typename... Types>
+class co_mpmc_channel;
+template <typename... Types>
 class co_nil_channel;
 template <typename... Types>
 class co_csp_channel;
@@ -3477,26 +3605,21 @@ public:
 };
 
 /*!
-@brief 첽channelͨ
+@brief 첽channelͨţBufferΪ
 */
-template <typename... Types>
-class co_channel
+template <typename Buffer, typename... Types>
+class CoChannel_
 {
 	typedef std::tuple<TYPE_PIPE(Types)...> msg_type;
 public:
-	co_channel(const shared_strand& strand, size_t buffLength = 1)
+	CoChannel_(const shared_strand& strand, size_t buffLength)
 		:_closed(false), _strand(strand), _buffer(buffLength) {}
 
-	~co_channel()
+	~CoChannel_()
 	{
 		assert(_pushWait.empty());
 		assert(_popWait.empty());
 	}
-
-	static std::shared_ptr<co_channel> make(const shared_strand& strand, size_t buffLength = 1)
-	{
-		return std::make_shared<co_channel>(strand, buffLength);
-	}
 public:
 	template <typename... Args>
 	void try_send(Args&&... msg)
@@ -3715,6 +3838,56 @@ public:
 		_try_pop(std::forward<Notify>(ntf));
 	}
 
+	/*!
+	@brief ͬһstrandʱĿpushδʱֱд룬첽֪ͨ
+	дֻһ_popWaitеȴ߲Ż
+	@return ѹرջ򻺳ʱfalseɵ÷aff_push
+	*/
+	template <typename... Args>
+	bool aff_fast_push(Args&&... msg)
+	{
+		assert(_strand->running_in_this_thread());
+		if (_closed || _buffer.full())
+		{
+			return false;
+		}
+		EVENT_TRACE(et_chan_push, this);
+		_buffer.push_back(std::forward<Args>(msg)...);
+		if (!_popWait.empty())
+		{
+			assert(1 == _buffer.size());
+			CoNotifyHandlerFace_* popNtf = _popWait.front();
+			_popWait.pop_front();
+			popNtf->invoke(_alloc);
+		}
+		return true;
+	}
+
+	/*!
+	@brief ͬһstrandʱĿpopǿʱֱȡ첽֪ͨ
+	ȡֻһ_pushWaitеȴ߲Ż
+	@return ѹرջ򻺳Ϊʱfalseɵ÷aff_pop
+	*/
+	template <typename... Outs>
+	bool aff_fast_pop(Outs&... outs)
+	{
+		assert(_strand->running_in_this_thread());
+		if (_closed || _buffer.empty())
+		{
+			return false;
+		}
+		EVENT_TRACE(et_chan_pop, this);
+		std::tie(outs...) = std::move(_buffer.front());
+		_buffer.pop_front();
+		if (!_pushWait.empty())
+		{
+			CoNotifyHandlerFace_* pushNtf = _pushWait.front();
+			_pushWait.pop_front();
+			pushNtf->invoke(_alloc);
+		}
+		return true;
+	}
+
 	template <typename Notify>
 	void timed_pop(int ms, Notify&& ntf)
 	{
@@ -3993,19 +4166,19 @@ public:
 		return _strand;
 	}
 
-	CoOtherReceiver_<co_channel<Types...>> other_receiver()
+	CoOtherReceiver_<CoChannel_> other_receiver()
 	{
-		return CoOtherReceiver_<co_channel<Types...>>{*this};
+		return CoOtherReceiver_<CoChannel_>{*this};
 	}
 
-	CoWrapTrySend_<co_channel<Types...>> wrap_try_send()
+	CoWrapTrySend_<CoChannel_> wrap_try_send()
 	{
-		return CoWrapTrySend_<co_channel<Types...>>{*this};
+		return CoWrapTrySend_<CoChannel_>{*this};
 	}
 
-	CoWrapTryPost_<co_channel<Types...>> wrap_try_post()
+	CoWrapTryPost_<CoChannel_> wrap_try_post()
 	{
-		return CoWrapTryPost_<co_channel<Types...>>{*this};
+		return CoWrapTryPost_<CoChannel_>{*this};
 	}
 private:
 	template <typename Notify, typename... Args>
@@ -4019,6 +4192,7 @@ private:
 		}
 		if (_buffer.full())
 		{
+			EVENT_TRACE(et_chan_wait, this);
 			_pushWait.push_back(CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this](co_async_state state, typename CoChanMsgMove_<Notify>::type& ntf, typename CoChanMsgMove_<Args>::type&... msg)
 			{
 				if (co_async_state::co_async_ok == state)
@@ -4034,6 +4208,7 @@ private:
 		}
 		else
 		{
+			EVENT_TRACE(et_chan_push, this);
 			_buffer.push_back(std::forward<Args>(msg)...);
 			if (!_popWait.empty())
 			{
@@ -4061,6 +4236,7 @@ private:
 		}
 		else
 		{
+			EVENT_TRACE(et_chan_push, this);
 			_buffer.push_back(std::forward<Args>(msg)...);
 			if (!_popWait.empty())
 			{
@@ -4116,6 +4292,7 @@ private:
 		}
 		else
 		{
+			EVENT_TRACE(et_chan_push, this);
 			_buffer.push_back(std::forward<Args>(msg)...);
 			if (!_popWait.empty())
 			{
@@ -4168,6 +4345,7 @@ private:
 		}
 		else
 		{
+			EVENT_TRACE(et_chan_push, this);
 			_buffer.push_back(std::forward<Args>(msg)...);
 			if (!_popWait.empty())
 			{
@@ -4191,6 +4369,7 @@ private:
 		}
 		if (!_buffer.empty())
 		{
+			EVENT_TRACE(et_chan_pop, this);
 			msg_type msg(std::move(_buffer.front()));
 			_buffer.pop_front();
 			if (!_pushWait.empty())
@@ -4203,6 +4382,7 @@ private:
 		}
 		else
 		{
+			EVENT_TRACE(et_chan_wait, this);
 			_popWait.push_back(CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf, co_async_state state)
 			{
 				if (co_async_state::co_async_ok == state)
@@ -4229,6 +4409,7 @@ private:
 		}
 		if (!_buffer.empty())
 		{
+			EVENT_TRACE(et_chan_pop, this);
 			msg_type msg(std::move(_buffer.front()));
 			_buffer.pop_front();
 			if (!_pushWait.empty())
@@ -4256,6 +4437,7 @@ private:
 		}
 		if (!_buffer.empty())
 		{
+			EVENT_TRACE(et_chan_pop, this);
 			msg_type msg(std::move(_buffer.front()));
 			_buffer.pop_front();
 			if (!_pushWait.empty())
@@ -4308,6 +4490,7 @@ private:
 		}
 		if (!_buffer.empty())
 		{
+			EVENT_TRACE(et_chan_pop, this);
 			msg_type msg(std::move(_buffer.front()));
 			_buffer.pop_front();
 			if (!_pushWait.empty())
@@ -4386,6 +4569,7 @@ private:
 		}
 		if (!_buffer.empty())
 		{
+			EVENT_TRACE(et_chan_pop, this);
 			msg_type msg(std::move(_buffer.front()));
 			_buffer.pop_front();
 			if (!_pushWait.empty())
@@ -4665,12 +4849,468 @@ private:
 	}
 private:
 	shared_strand _strand;
-	fixed_buffer<msg_type> _buffer;
+	Buffer _buffer;
 	reusable_mem _alloc;
 	msg_list<CoNotifyHandlerFace_*> _pushWait;
 	msg_list<CoNotifyHandlerFace_*> _popWait;
 	bool _closed;
-	NONE_COPY(co_channel);
+	NONE_COPY(CoChannel_);
+};
+
+/*!
+@brief 첽channelͨ
+*/
+template <typename... Types>
+class co_channel : public CoChannel_<fixed_buffer<std::tuple<TYPE_PIPE(Types)...>>, Types...>
+{
+public:
+	co_channel(const shared_strand& strand, size_t buffLength = 1)
+		:CoChannel_<fixed_buffer<std::tuple<TYPE_PIPE(Types)...>>, Types...>(strand, buffLength) {}
+
+	static std::shared_ptr<co_channel> make(const shared_strand& strand, size_t buffLength = 1)
+	{
+		return std::make_shared<co_channel>(strand, buffLength);
+	}
+};
+
+/*!
+@brief 첽channelͨţϢ2ݶλ
+*/
+template <typename... Types>
+class co_ring_channel : public CoChannel_<ring_buffer<std::tuple<TYPE_PIPE(Types)...>>, Types...>
+{
+public:
+	co_ring_channel(const shared_strand& strand, size_t buffLength = 1)
+		:CoChannel_<ring_buffer<std::tuple<TYPE_PIPE(Types)...>>, Types...>(strand, buffLength) {}
+
+	static std::shared_ptr<co_ring_channel> make(const shared_strand& strand, size_t buffLength = 1)
+	{
+		return std::make_shared<co_ring_channel>(strand, buffLength);
+	}
+};
+
+/*!
+@brief strand첽channelͨţϢMPMCУ
+߳push/popɹʱлstrandֻдڵȴʱͶݻѵchannelstrand
+峤Ȱ2ݶ룬֧timed/select
+*/
+template <typename... Types>
+class co_mpmc_channel
+{
+	typedef std::tuple<TYPE_PIPE(Types)...> msg_type;
+public:
+	co_mpmc_channel(const shared_strand& strand, size_t buffLength = 1)
+		:_strand(strand), _buffer(buffLength), _pushWaitCount(0), _popWaitCount(0), _closed(false) {}
+
+	~co_mpmc_channel()
+	{
+		assert(_pushWait.empty());
+		assert(_popWait.empty());
+	}
+
+	static std::shared_ptr<co_mpmc_channel> make(const shared_strand& strand, size_t buffLength = 1)
+	{
+		return std::make_shared<co_mpmc_channel>(strand, buffLength);
+	}
+public:
+	template <typename... Args>
+	void try_send(Args&&... msg)
+	{
+		try_push(any_handler(), std::forward<Args>(msg)...);
+	}
+
+	template <typename... Args>
+	void try_post(Args&&... msg)
+	{
+		try_push(any_handler(), std::forward<Args>(msg)...);
+	}
+
+	template <typename Notify, typename... Args>
+	void push(Notify&& ntf, Args&&... msg)
+	{
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+			return;
+		}
+		//ʧʱmsgᱻƶ
+		if (_buffer.try_push_back(std::forward<Args>(msg)...))
+		{
+			notify_pop();
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
+		}
+		else if (_strand->running_in_this_thread())
+		{
+			_push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+		}
+		else
+		{
+			_strand->post(std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf, typename CoChanMsgMove_<Args>::type&... msg)
+			{
+				_push(CoChanMsgMove_<Notify>::move(ntf), CoChanMsgMove_<Args>::move(msg)...);
+			}, CoChanMsgMove_<Notify>::forward(ntf), CoChanMsgMove_<Args>::forward(msg)...));
+		}
+	}
+
+	template <typename Notify, typename... Args>
+	void tick_push(Notify&& ntf, Args&&... msg)
+	{
+		push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+	}
+
+	template <typename Notify, typename... Args>
+	void aff_push(Notify&& ntf, Args&&... msg)
+	{
+		assert(_strand->running_in_this_thread());
+		push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+	}
+
+	template <typename Notify, typename... Args>
+	void try_push(Notify&& ntf, Args&&... msg)
+	{
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+		}
+		else if (_buffer.try_push_back(std::forward<Args>(msg)...))
+		{
+			notify_pop();
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
+		}
+		else
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_fail);
+		}
+	}
+
+	template <typename Notify, typename... Args>
+	void try_tick_push(Notify&& ntf, Args&&... msg)
+	{
+		try_push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+	}
+
+	template <typename Notify, typename... Args>
+	void aff_try_push(Notify&& ntf, Args&&... msg)
+	{
+		assert(_strand->running_in_this_thread());
+		try_push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+	}
+
+	template <typename Notify>
+	void pop(Notify&& ntf)
+	{
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+		}
+		else if (!try_pop_invoke(ntf))
+		{
+			if (_strand->running_in_this_thread())
+			{
+				_pop(std::forward<Notify>(ntf));
+			}
+			else
+			{
+				_strand->post(std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf)
+				{
+					_pop(CoChanMsgMove_<Notify>::move(ntf));
+				}, CoChanMsgMove_<Notify>::forward(ntf)));
+			}
+		}
+	}
+
+	template <typename Notify>
+	void tick_pop(Notify&& ntf)
+	{
+		pop(std::forward<Notify>(ntf));
+	}
+
+	template <typename Notify>
+	void aff_pop(Notify&& ntf)
+	{
+		assert(_strand->running_in_this_thread());
+		pop(std::forward<Notify>(ntf));
+	}
+
+	template <typename Notify>
+	void try_pop(Notify&& ntf)
+	{
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+		}
+		else if (!try_pop_invoke(ntf))
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_fail);
+		}
+	}
+
+	template <typename Notify>
+	void try_tick_pop(Notify&& ntf)
+	{
+		try_pop(std::forward<Notify>(ntf));
+	}
+
+	template <typename Notify>
+	void aff_try_pop(Notify&& ntf)
+	{
+		assert(_strand->running_in_this_thread());
+		try_pop(std::forward<Notify>(ntf));
+	}
+
+	void close()
+	{
+		_strand->distribute([this]()
+		{
+			_close();
+		});
+	}
+
+	template <typename Notify>
+	void close(Notify&& ntf)
+	{
+		if (_strand->running_in_this_thread())
+		{
+			_close();
+			CHECK_EXCEPTION(ntf);
+		}
+		else
+		{
+			_strand->post(std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf)
+			{
+				_close();
+				CHECK_EXCEPTION(ntf);
+			}, CoChanMsgMove_<Notify>::forward(ntf)));
+		}
+	}
+
+	void cancel()
+	{
+		_strand->distribute([this]()
+		{
+			_cancel();
+		});
+	}
+
+	template <typename Notify>
+	void cancel(Notify&& ntf)
+	{
+		if (_strand->running_in_this_thread())
+		{
+			_cancel();
+			CHECK_EXCEPTION(ntf);
+		}
+		else
+		{
+			_strand->post(std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf)
+			{
+				_cancel();
+				CHECK_EXCEPTION(ntf);
+			}, CoChanMsgMove_<Notify>::forward(ntf)));
+		}
+	}
+
+	void reset()
+	{
+		assert(_closed);
+		assert(_pushWait.empty());
+		assert(_popWait.empty());
+		_buffer.clear();
+		_closed = false;
+	}
+
+	const shared_strand& self_strand() const
+	{
+		return _strand;
+	}
+private:
+	template <typename Notify>
+	bool try_pop_invoke(Notify& ntf)
+	{
+		return _buffer.try_pop_front([&](msg_type& msg)
+		{
+			notify_push();
+			CHECK_EXCEPTION(tuple_invoke, ntf, std::tuple<co_async_state>(co_async_state::co_async_ok), std::move(msg));
+		});
+	}
+
+	void notify_push()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_pushWaitCount.load(std::memory_order_relaxed))
+		{
+			_strand->distribute([this]()
+			{
+				_invoke_front(_pushWait, _pushWaitCount);
+			});
+		}
+	}
+
+	void notify_pop()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_popWaitCount.load(std::memory_order_relaxed))
+		{
+			_strand->distribute([this]()
+			{
+				_invoke_front(_popWait, _popWaitCount);
+			});
+		}
+	}
+
+	template <typename Notify, typename... Args>
+	void _push(Notify&& ntf, Args&&... msg)
+	{
+		assert(_strand->running_in_this_thread());
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+			return;
+		}
+		if (_buffer.try_push_back(std::forward<Args>(msg)...))
+		{
+			notify_pop();
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
+			return;
+		}
+		_pushWait.push_back(CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this](co_async_state state, typename CoChanMsgMove_<Notify>::type& ntf, typename CoChanMsgMove_<Args>::type&... msg)
+		{
+			if (co_async_state::co_async_ok == state)
+			{
+				_push(CoChanMsgMove_<Notify>::move(ntf), CoChanMsgMove_<Args>::move(msg)...);
+			}
+			else
+			{
+				CHECK_EXCEPTION(ntf, state);
+			}
+		}, __1, CoChanMsgMove_<Notify>::forward(ntf), CoChanMsgMove_<Args>::forward(msg)...)));
+		_pushWaitCount++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!_buffer.full())
+		{//Ǽǵȴʱпλ߿ûȴ
+			_invoke_back(_pushWait, _pushWaitCount);
+		}
+	}
+
+	template <typename Notify>
+	void _pop(Notify&& ntf)
+	{
+		assert(_strand->running_in_this_thread());
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+			return;
+		}
+		if (try_pop_invoke(ntf))
+		{
+			return;
+		}
+		_popWait.push_back(CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf, co_async_state state)
+		{
+			if (co_async_state::co_async_ok == state)
+			{
+				_pop(CoChanMsgMove_<Notify>::move(ntf));
+			}
+			else
+			{
+				CHECK_EXCEPTION(ntf, state);
+			}
+		}, CoChanMsgMove_<Notify>::forward(ntf), __1)));
+		_popWaitCount++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!_buffer.empty())
+		{//ǼǵȴʱϢ߿ûȴ
+			_invoke_back(_popWait, _popWaitCount);
+		}
+	}
+
+	void _invoke_front(msg_list<CoNotifyHandlerFace_*>& waitQueue, std::atomic<size_t>& waitCount)
+	{
+		assert(_strand->running_in_this_thread());
+		if (!waitQueue.empty())
+		{
+			CoNotifyHandlerFace_* ntf = waitQueue.front();
+			waitQueue.pop_front();
+			waitCount--;
+			ntf->invoke(_alloc);
+		}
+	}
+
+	void _invoke_back(msg_list<CoNotifyHandlerFace_*>& waitQueue, std::atomic<size_t>& waitCount)
+	{
+		assert(_strand->running_in_this_thread());
+		assert(!waitQueue.empty());
+		CoNotifyHandlerFace_* ntf = waitQueue.back();
+		waitQueue.pop_back();
+		waitCount--;
+		ntf->invoke(_alloc);
+	}
+
+	void _invoke_all(co_async_state state)
+	{
+		assert(_strand->running_in_this_thread());
+		size_t ntfNum = 0;
+		CoNotifyHandlerFace_* ntfs[32];
+		std::list<CoNotifyHandlerFace_*> ntfsEx;
+		while (!_pushWait.empty())
+		{
+			if (ntfNum < static_array_length(ntfs))
+			{
+				ntfs[ntfNum++] = _pushWait.front();
+			}
+			else
+			{
+				ntfsEx.push_back(_pushWait.front());
+			}
+			_pushWait.pop_front();
+		}
+		while (!_popWait.empty())
+		{
+			if (ntfNum < static_array_length(ntfs))
+			{
+				ntfs[ntfNum++] = _popWait.front();
+			}
+			else
+			{
+				ntfsEx.push_back(_popWait.front());
+			}
+			_popWait.pop_front();
+		}
+		_pushWaitCount = 0;
+		_popWaitCount = 0;
+		for (size_t i = 0; i < ntfNum; i++)
+		{
+			ntfs[i]->invoke(_alloc, state);
+		}
+		while (!ntfsEx.empty())
+		{
+			ntfsEx.front()->invoke(_alloc, state);
+			ntfsEx.pop_front();
+		}
+	}
+
+	void _close()
+	{
+		assert(_strand->running_in_this_thread());
+		_closed = true;
+		_buffer.clear();
+		_invoke_all(co_async_state::co_async_closed);
+	}
+
+	void _cancel()
+	{
+		_invoke_all(co_async_state::co_async_cancel);
+	}
+private:
+	shared_strand _strand;
+	mpmc_ring_queue<msg_type> _buffer;
+	reusable_mem _alloc;
+	msg_list<CoNotifyHandlerFace_*> _pushWait;
+	msg_list<CoNotifyHandlerFace_*> _popWait;
+	std::atomic<size_t> _pushWaitCount;
+	std::atomic<size_t> _popWaitCount;
+	std::atomic<bool> _closed;
+	NONE_COPY(co_mpmc_channel);
 };
 
 template <>
@@ -7644,12 +8284,14 @@ private:
 		assert(check_self_err_call(id));
 		if (!_lockActorID || id == _lockActorID)
 		{
+			EVENT_TRACE(et_mutex_lock, id);
 			_lockActorID = id;
 			_recCount++;
 			CHECK_EXCEPTION(ntf);
 		}
 		else
 		{
+			EVENT_TRACE(et_mutex_wait, id);
 			_waitQueue.push_back(wait_node{ CoNotifyHandlerFace_::wrap_nil_state_notify(_alloc, std::forward<Notify>(ntf)), id });
 			CHECK_EXCEPTION(lockedNtf);
 		}
@@ -7662,6 +8304,7 @@ private:
 		assert(check_self_err_call(id));
 		if (!_lockActorID || id == _lockActorID)
 		{
+			EVENT_TRACE(et_mutex_lock, id);
 			_lockActorID = id;
 			_recCount++;
 			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
@@ -7691,6 +8334,7 @@ private:
 		assert(check_self_err_call(id));
 		if (!_lockActorID || id == _lockActorID)
 		{
+			EVENT_TRACE(et_mutex_lock, id);
 			_lockActorID = id;
 			_recCount++;
 			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
@@ -7698,6 +8342,7 @@ private:
 		else if (ms > 0)
 		{
 			overlap_timer::timer_handle* timer = new(_alloc.allocate(sizeof(overlap_timer::timer_handle)))overlap_timer::timer_handle;
+			EVENT_TRACE(et_mutex_wait, id);
 			_waitQueue.push_back(wait_node{ CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this, timer](co_async_state state, typename CoChanMsgMove_<Notify>::type& ntf)
 			{
 				_strand->over_timer()->cancel(*timer);
@@ -7726,12 +8371,14 @@ private:
 		assert(check_self_err_call(id));
 		if (!_lockActorID || id == _lockActorID)
 		{
+			EVENT_TRACE(et_mutex_lock, id);
 			_lockActorID = id;
 			_recCount++;
 			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
 		}
 		else if (ms > 0)
 		{
+			EVENT_TRACE(et_mutex_wait, id);
 			_waitQueue.push_back(wait_node{ CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this, &timer](co_async_state state, typename CoChanMsgMove_<Notify>::type& ntf)
 			{
 				_strand->over_timer()->cancel(timer);
@@ -7755,12 +8402,14 @@ private:
 	{
 		if (0 == --_recCount)
 		{
+			EVENT_TRACE(et_mutex_unlock, id);
 			if (!_waitQueue.empty())
 			{
 				_recCount = 1;
 				wait_node queueFront = _waitQueue.front();
 				_waitQueue.pop_front();
 				_lockActorID = queueFront._waitHostID;
+				EVENT_TRACE(et_mutex_lock, _lockActorID);
 				queueFront._ntf->invoke(_alloc);
 			}
 			else
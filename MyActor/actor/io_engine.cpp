@@ -4,6 +4,7 @@
 #include "generator.h"
 #include "context_yield.h"
 #include "waitable_timer.h"
+#include <thread>
 
 #ifdef ASIO_HANDLER_ALLOCATE_EX
 
@@ -116,13 +117,65 @@ void io_engine::uninstall()
 #endif
 }
 
+//work_stealingģʽ߳
+#ifndef STEAL_MAX_WORKERS
+#define STEAL_MAX_WORKERS 256
+#endif
+
+//work_stealingģʽִжٸstrandһasio
+#ifndef STEAL_POLL_INTERVAL
+#define STEAL_POLL_INTERVAL 61
+#endif
+
+#if (defined _MSC_VER)
+#define CPU_PAUSE() YieldProcessor()
+#elif (__i386__ || __x86_64__)
+#define CPU_PAUSE() __builtin_ia32_pause()
+#elif (__arm__ || __aarch64__)
+#define CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#define CPU_PAUSE()
+#endif
+
+#ifdef ENABLE_SCHEDULER_STATS
+#define STATS_HANDLERS(__n__) statsSlot->_handlerCount.fetch_add(__n__, std::memory_order_relaxed)
+
+io_engine::stats_slot::stats_slot()
+:_taskCount(0), _handlerCount(0), _busyTime(0), _beginTime(0), _endTime(0) {}
+
+void io_engine::stats_slot::clear()
+{
+	_taskCount.store(0, std::memory_order_relaxed);
+	_handlerCount.store(0, std::memory_order_relaxed);
+	_busyTime.store(0, std::memory_order_relaxed);
+	_beginTime.store(get_tick_ns(), std::memory_order_relaxed);
+	_endTime.store(0, std::memory_order_relaxed);
+}
+#else
+#define STATS_HANDLERS(__n__)
+#endif
+
 io_engine::io_engine(bool enableTimer, const char* title)
 :io_engine(MEM_POOL_LENGTH, enableTimer, title) {}
 
-io_engine::io_engine(size_t poolSize, bool enableTimer, const char* title)
+io_engine::io_engine(schedule_mode mode, bool enableTimer, const char* title)
+:io_engine(MEM_POOL_LENGTH, enableTimer, title, mode) {}
+
+io_engine::io_engine(size_t poolSize, bool enableTimer, const char* title, schedule_mode mode)
+:_stealNumber(0), _stealHome(0), _idleNumber(0), _idleSpinUs(0), _idleYieldUs(0)
+, _spinWakeCount(0), _yieldWakeCount(0), _parkCount(0)
 {
+#ifdef ENABLE_SCHEDULER_STATS
+	_statsNumber = 0;
+#endif
 	_opend = false;
 	_runLock = NULL;
+	_scheduleMode = mode;
+	if (work_stealing == _scheduleMode)
+	{
+		_stealWorkers.reserve(STEAL_MAX_WORKERS);
+		_stealWorkers.push_back(new steal_worker(this, 0));
+	}
 	_poolSize = poolSize > 4 ? poolSize : 4;
 	_title = title ? title : "io_engine";
 #ifdef WIN32
@@ -157,26 +210,80 @@ io_engine::io_engine(size_t poolSize, bool enableTimer, const char* title)
 io_engine::~io_engine()
 {
 	assert(!_opend);
+	//strandеĶʱʱҪ_waitableTimer
+	delete _strandPool;
 #ifdef DISABLE_BOOST_TIMER
 #ifndef ENABLE_GLOBAL_TIMER
 	delete _waitableTimer;
 #endif
 #endif
-	delete _strandPool;
+	for (steal_worker* const ele : _stealWorkers)
+	{
+		assert(ele->_strandQueue.empty());
+		delete ele;
+	}
+#ifdef ENABLE_SCHEDULER_STATS
+	for (stats_slot* const ele : _statsSlots)
+	{
+		delete ele;
+	}
+#endif
 }
 
 void io_engine::run(size_t threadNum, sched policy)
+{
+	run(threadNum, std::vector<int>(), policy);
+}
+
+void io_engine::run(size_t threadNum, const std::vector<int>& cpuList, sched policy)
 {
 	assert(threadNum >= 1);
 	std::lock_guard<std::mutex> lg(_runMutex);
 	if (!_opend)
 	{
 		_opend = true;
+		_cpuList.clear();
+		for (int cpu : cpuList)
+		{
+			if (cpu >= 0)
+			{
+				_cpuList.push_back(cpu);
+			}
+			else
+			{
+				warning_trace_line("io_engine ignore invalid cpu id ", cpu);
+			}
+		}
+		_spinWakeCount = 0;
+		_yieldWakeCount = 0;
+		_parkCount = 0;
 		_runCount = 0;
 		_runLock = new boost::asio::io_service::work(_ios);
 		_handleList.resize(threadNum);
 #ifdef __linux__
 		_policy = policy;
+#endif
+		if (work_stealing == _scheduleMode)
+		{
+			assert(threadNum <= STEAL_MAX_WORKERS);
+			while (_stealWorkers.size() < threadNum)
+			{
+				_stealWorkers.push_back(new steal_worker(this, _stealWorkers.size()));
+			}
+			_stealNumber = threadNum;
+		}
+#ifdef ENABLE_SCHEDULER_STATS
+		_ctrlMutex.lock();
+		while (_statsSlots.size() < threadNum)
+		{
+			_statsSlots.push_back(new stats_slot());
+		}
+		for (size_t i = 0; i < threadNum; i++)
+		{
+			_statsSlots[i]->clear();
+		}
+		_statsNumber = threadNum;
+		_ctrlMutex.unlock();
 #endif
 		size_t rc = 0;
 		std::shared_ptr<std::mutex> blockMutex = std::make_shared<std::mutex>();
@@ -190,6 +297,14 @@ void io_engine::run(size_t threadNum, sched policy)
 				{
 					{
 						run_thread::set_current_thread_name(_title.c_str());
+						if (!_cpuList.empty())
+						{
+							const int cpu = _cpuList[i % _cpuList.size()];
+							if (!run_thread::set_current_thread_affinity(cpu))
+							{
+								warning_trace_line("io_engine thread ", i, " set affinity to cpu ", cpu, " failed");
+							}
+						}
 #ifdef WIN32
 						SetThreadPriority(GetCurrentThread(), _priority);
 						DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &_handleList[i], 0, FALSE, DUPLICATE_SAME_ACCESS);
@@ -218,6 +333,11 @@ void io_engine::run(size_t threadNum, sched policy)
 					context_yield::convert_thread_to_fiber();
 					__space_align void* tlsBuff[64] = { 0 };
 					_tls->set_space(tlsBuff);
+					tlsBuff[IO_ENGINE_TLS_INDEX] = this;
+#ifdef ENABLE_SCHEDULER_STATS
+					stats_slot* const statsSlot = _statsSlots[i];
+					tlsBuff[SCHEDULER_STATS_TLS_INDEX] = statsSlot;
+#endif
 					my_actor::tls_init();
 					generator::tls_init();
 #ifdef ASIO_HANDLER_ALLOCATE_EX
@@ -246,7 +366,32 @@ void io_engine::run(size_t threadNum, sched policy)
 					__space_align char dumpStack[8 kB];
 					my_actor::dump_segmentation_fault(dumpStack, sizeof(dumpStack));
 #endif
-					_runCount += _ios.run();
+					if (work_stealing == _scheduleMode)
+					{
+						_runCount += stealRun(_stealWorkers[i]);
+					}
+					else if (_idleSpinUs > 0 || _idleYieldUs > 0)
+					{
+						_runCount += sharedRun();
+					}
+					else
+					{
+#ifdef ENABLE_SCHEDULER_STATS
+						size_t runCount = 0;
+						boost::system::error_code ec;
+						while (_ios.run_one(ec))
+						{
+							runCount++;
+							STATS_HANDLERS(1);
+						}
+						_runCount += runCount;
+#else
+						_runCount += _ios.run();
+#endif
+					}
+#ifdef ENABLE_SCHEDULER_STATS
+					statsSlot->_endTime.store(get_tick_ns(), std::memory_order_relaxed);
+#endif
 #if (__linux__ && ENABLE_DUMP_STACK)
 					my_actor::undump_segmentation_fault();
 #endif
@@ -260,6 +405,12 @@ void io_engine::run(size_t threadNum, sched policy)
 #endif
 					generator::tls_uninit();
 					my_actor::tls_uninit();
+#ifndef TRACE_ANDROID_LOG
+					TraceAsync_::tls_uninit();
+#endif
+#ifdef ENABLE_EVENT_TRACE
+					event_trace::tls_uninit();
+#endif
 					_tls->set_space(NULL);
 					context_yield::convert_fiber_to_thread();
 				}
@@ -305,6 +456,7 @@ void io_engine::stop()
 			_runThreads.pop_front();
 		}
 		_ios.reset();
+		_stealNumber = 0;
 		_threadsID.clear();
 		_ctrlMutex.lock();
 		for (auto& ele : _handleList)
@@ -321,10 +473,54 @@ void io_engine::stop()
 	}
 }
 
+std::vector<int> io_engine::parseCpuList(const char* str)
+{
+	std::vector<int> res;
+	while (str && *str)
+	{
+		char* end = NULL;
+		const int first = (int)strtol(str, &end, 10);
+		if (end == str)
+		{
+			break;
+		}
+		int last = first;
+		if ('-' == *end)
+		{
+			str = end + 1;
+			last = (int)strtol(str, &end, 10);
+			if (end == str)
+			{
+				break;
+			}
+		}
+		if (first < 0 || last < first)
+		{//
+			break;
+		}
+		for (int i = first; i <= last; i++)
+		{
+			res.push_back(i);
+		}
+		if (',' != *end)
+		{
+			break;
+		}
+		str = end + 1;
+	}
+	return res;
+}
+
+const std::vector<int>& io_engine::cpuList()
+{
+	return _cpuList;
+}
+
 bool io_engine::runningInThisIos()
 {
 	assert(_opend);
-	return _threadsID.find(run_thread::this_thread_id()) != _threadsID.end();
+	void** const tlsBuff = getTlsValueBuff();
+	return tlsBuff && this == tlsBuff[IO_ENGINE_TLS_INDEX];
 }
 
 size_t io_engine::threadNumber()
@@ -374,6 +570,11 @@ long long io_engine::getRunCount()
 	return _runCount;
 }
 
+io_engine::schedule_mode io_engine::scheduleMode()
+{
+	return _scheduleMode;
+}
+
 const std::set<run_thread::thread_id>& io_engine::threadsID()
 {
 	return _threadsID;
@@ -424,4 +625,241 @@ void* io_engine::swapTlsValue(int i, void* val)
 void** io_engine::getTlsValueBuff()
 {
 	return _tls->get_space();
+}
+
+#ifdef ENABLE_SCHEDULER_STATS
+std::vector<io_engine::thread_stats> io_engine::stats()
+{
+	std::vector<thread_stats> res;
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	res.resize(_statsNumber);
+	const long long now = get_tick_ns();
+	for (size_t i = 0; i < _statsNumber; i++)
+	{
+		stats_slot* const slot = _statsSlots[i];
+		const long long endTime = slot->_endTime.load(std::memory_order_relaxed);
+		const long long busyTime = slot->_busyTime.load(std::memory_order_relaxed);
+		const long long totalTime = (endTime ? endTime : now) - slot->_beginTime.load(std::memory_order_relaxed);
+		res[i].index = i;
+		res[i].tasks = slot->_taskCount.load(std::memory_order_relaxed);
+		res[i].handlers = slot->_handlerCount.load(std::memory_order_relaxed);
+		res[i].busyTime = busyTime / 1000;
+		res[i].idleTime = (totalTime > busyTime ? totalTime - busyTime : 0) / 1000;
+	}
+	return res;
+}
+#endif
+
+size_t io_engine::stealRun(steal_worker* worker)
+{
+	setTlsValue(STEAL_WORKER_TLS_INDEX, worker);
+#ifdef ENABLE_SCHEDULER_STATS
+	stats_slot* const statsSlot = (stats_slot*)getTlsValue(SCHEDULER_STATS_TLS_INDEX);
+#endif
+	size_t runCount = 0;
+	size_t pollCount = 0;
+	size_t n = 0;
+	boost::system::error_code ec;
+	while (true)
+	{
+		StrandEx_* strand = stealPop(worker);
+		if (strand)
+		{
+			runCount++;
+			STATS_HANDLERS(1);
+			if (!strand->_preferHome)
+			{
+				strand->_homeWorker = worker->_index;
+			}
+			if (strand->run_tasks())
+			{//strandлŵضβ
+				if (strand->_preferHome && strand->_homeWorker % _stealNumber != worker->_index)
+				{//ȡִеstrandص߳
+					stealSchedule(strand);
+				}
+				else
+				{
+					std::lock_guard<std::mutex> lg(worker->_mutex);
+					worker->_strandQueue.push_back(strand);
+				}
+			}
+			if (STEAL_POLL_INTERVAL == ++pollCount)
+			{//ֹضһֱʱasioеIO¼
+				pollCount = 0;
+				n = _ios.poll(ec);
+				runCount += n;
+				STATS_HANDLERS(n);
+			}
+			continue;
+		}
+		pollCount = 0;
+		n = _ios.poll(ec);
+		if (n)
+		{
+			runCount += n;
+			STATS_HANDLERS(n);
+			continue;
+		}
+		if (idleSpin([&]()->bool
+		{
+			StrandEx_* const stolen = stealPop(worker);
+			if (stolen)
+			{
+				std::lock_guard<std::mutex> lg(worker->_mutex);
+				worker->_strandQueue.push_front(stolen);
+				return true;
+			}
+			n = _ios.poll(ec);
+			runCount += n;
+			STATS_HANDLERS(n);
+			return 0 != n;
+		}))
+		{
+			continue;
+		}
+		_idleNumber++;
+		strand = stealPop(worker);
+		if (strand)
+		{
+			_idleNumber--;
+			std::lock_guard<std::mutex> lg(worker->_mutex);
+			worker->_strandQueue.push_front(strand);
+			continue;
+		}
+		if (_idleSpinUs > 0 || _idleYieldUs > 0)
+		{
+			_parkCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		n = _ios.run_one(ec);
+		_idleNumber--;
+		if (!n)
+		{//strandasioɣiosֹͣ
+			break;
+		}
+		runCount += n;
+		STATS_HANDLERS(n);
+	}
+	setTlsValue(STEAL_WORKER_TLS_INDEX, NULL);
+	return runCount;
+}
+
+size_t io_engine::sharedRun()
+{
+#ifdef ENABLE_SCHEDULER_STATS
+	stats_slot* const statsSlot = (stats_slot*)getTlsValue(SCHEDULER_STATS_TLS_INDEX);
+#endif
+	size_t runCount = 0;
+	boost::system::error_code ec;
+	while (true)
+	{
+		size_t n = _ios.poll(ec);
+		if (!n && !idleSpin([&]()->bool
+		{
+			n = _ios.poll(ec);
+			return 0 != n;
+		}))
+		{
+			_parkCount.fetch_add(1, std::memory_order_relaxed);
+			n = _ios.run_one(ec);
+			if (!n)
+			{//ɣiosֹͣ
+				break;
+			}
+		}
+		runCount += n;
+		STATS_HANDLERS(n);
+	}
+	return runCount;
+}
+
+template <typename Poll>
+bool io_engine::idleSpin(Poll&& poll)
+{
+	const int spinUs = _idleSpinUs.load(std::memory_order_relaxed);
+	const int yieldUs = _idleYieldUs.load(std::memory_order_relaxed);
+	if (spinUs <= 0 && yieldUs <= 0)
+	{
+		return false;
+	}
+	const long long spinEnd = get_tick_us() + (spinUs > 0 ? spinUs : 0);
+	const long long yieldEnd = spinEnd + (yieldUs > 0 ? yieldUs : 0);
+	long long ct = 0;
+	do
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			if (poll())
+			{
+				_spinWakeCount.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+			CPU_PAUSE();
+		}
+	} while ((ct = get_tick_us()) < spinEnd);
+	while (ct < yieldEnd)
+	{
+		if (poll())
+		{
+			_yieldWakeCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+		std::this_thread::yield();
+		ct = get_tick_us();
+	}
+	return false;
+}
+
+void io_engine::setIdlePolicy(int spinUs, int yieldUs)
+{
+	_idleSpinUs = spinUs;
+	_idleYieldUs = yieldUs;
+}
+
+io_engine::idle_stats io_engine::idleStats()
+{
+	idle_stats res;
+	res.spinWake = _spinWakeCount.load(std::memory_order_relaxed);
+	res.yieldWake = _yieldWakeCount.load(std::memory_order_relaxed);
+	res.parked = _parkCount.load(std::memory_order_relaxed);
+	return res;
+}
+
+StrandEx_* io_engine::stealPop(steal_worker* worker)
+{
+	{
+		std::lock_guard<std::mutex> lg(worker->_mutex);
+		if (!worker->_strandQueue.empty())
+		{
+			return static_cast<StrandEx_*>(worker->_strandQueue.pop_front());
+		}
+	}
+	const size_t number = _stealNumber;
+	for (size_t i = 1; i < number; i++)
+	{
+		steal_worker* const victim = _stealWorkers[(worker->_index + i) % number];
+		std::lock_guard<std::mutex> lg(victim->_mutex);
+		if (!victim->_strandQueue.empty())
+		{
+			return static_cast<StrandEx_*>(victim->_strandQueue.pop_front());
+		}
+	}
+	return NULL;
+}
+
+void io_engine::stealSchedule(StrandEx_* strand)
+{
+	const size_t number = _stealNumber;
+	steal_worker* const worker = _stealWorkers[number ? strand->_homeWorker % number : 0];
+	{
+		std::lock_guard<std::mutex> lg(worker->_mutex);
+		worker->_strandQueue.push_back(strand);
+	}
+	if (_idleNumber)
+	{
+		void** const tlsBuff = getTlsValueBuff();
+		if (!tlsBuff || worker != tlsBuff[STEAL_WORKER_TLS_INDEX])
+		{//һ߳
+			_ios.post(any_handler());
+		}
+	}
 }
\ No newline at end of file
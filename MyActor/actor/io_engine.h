@@ -13,6 +13,7 @@
 #include "mem_pool.h"
 #include "run_thread.h"
 #include "lambda_ref.h"
+#include "msg_queue.h"
 
 class my_actor;
 class boost_strand;
@@ -24,6 +25,7 @@ class WaitableTimerEvent_;
 class io_engine
 {
 	friend boost_strand;
+	friend StrandEx_;
 #ifdef DISABLE_BOOST_TIMER
 	friend WaitableTimerEvent_;
 #endif
@@ -65,9 +67,65 @@ public:
 		sched_other = SCHED_OTHER
 	};
 #endif
+
+	enum schedule_mode
+	{
+		shared_queue,//̹߳һasioȶ
+		work_stealing//ÿ߳һstrandУ̴߳߳ȡ
+	};
+private:
+	struct steal_worker
+	{
+		steal_worker(io_engine* engine, size_t index)
+		:_engine(engine), _index(index) {}
+
+		io_engine* const _engine;
+		const size_t _index;
+		std::mutex _mutex;
+		op_queue _strandQueue;
+	};
+
+#ifdef ENABLE_SCHEDULER_STATS
+	struct stats_slot
+	{
+		stats_slot();
+		void clear();
+
+		std::atomic<unsigned long long> _taskCount;
+		std::atomic<unsigned long long> _handlerCount;
+		std::atomic<long long> _busyTime;
+		std::atomic<long long> _beginTime;
+		std::atomic<long long> _endTime;
+	};
+#endif
+public:
+#ifdef ENABLE_SCHEDULER_STATS
+	/*!
+	@brief ߳ͳƿ
+	*/
+	struct thread_stats
+	{
+		size_t index;//߳
+		unsigned long long tasks;//ִеstrand
+		unsigned long long handlers;//ɵhandler(strand+asio¼)
+		long long busyTime;//ִstrandʱ(us)
+		long long idleTime;//ʱ䣬ȴstrand¼(us)
+	};
+#endif
+public:
+	/*!
+	@brief и׶д
+	*/
+	struct idle_stats
+	{
+		unsigned long long spinWake;//׶εȵ
+		unsigned long long yieldWake;//ó׶εȵ
+		unsigned long long parked;//ȴ
+	};
 public:
 	io_engine(bool enableTimer = true, const char* title = NULL);
-	io_engine(size_t poolSize, bool enableTimer = true, const char* title = NULL);
+	io_engine(schedule_mode mode, bool enableTimer = true, const char* title = NULL);
+	io_engine(size_t poolSize, bool enableTimer = true, const char* title = NULL, schedule_mode mode = shared_queue);
 	~io_engine();
 public:
 	/*!
@@ -77,6 +135,20 @@ public:
 	*/
 	void run(size_t threadNum = 1, sched policy = sched_other);
 
+	/*!
+	@brief ʼеḭ߳󶨵cpuList[i % cpuList.size()]
+	@param threadNum ߳
+	@param cpuList IDбΪʱ󶨣parseCpuList"0-3,8"ʽɣIDԣʧʱ
+	@param policy ̵߳Ȳ(linuxЧwinº)
+	*/
+	void run(size_t threadNum, const std::vector<int>& cpuList, sched policy = sched_other);
+
+	/*!
+	@brief cgroup cpusetʽĺб"0-3,8,10-11"
+	ʽ󡢸ʱֹ֮ͣǰѽĲ
+	*/
+	static std::vector<int> parseCpuList(const char* str);
+
 	/*!
 	@brief ȴʱ
 	*/
@@ -107,11 +179,21 @@ public:
 	*/
 	long long getRunCount();
 
+	/*!
+	@brief ģʽ
+	*/
+	schedule_mode scheduleMode();
+
 	/*!
 	@brief ߳ID
 	*/
 	const std::set<run_thread::thread_id>& threadsID();
 
+	/*!
+	@brief ̰߳󶨵ĺб
+	*/
+	const std::vector<int>& cpuList();
+
 	/*!
 	@brief ios title
 	*/
@@ -160,10 +242,34 @@ public:
 	@brief ȡtlsռ
 	*/
 	static void** getTlsValueBuff();
+
+	/*!
+	@brief ÿвԣȶΪʱspinUs΢룬ó߳yieldUs΢룬ȴ
+	Ϊ0ʱֱӹ(Ĭ)shared_queueģʽrun֮ǰ
+	*/
+	void setIdlePolicy(int spinUs, int yieldUs);
+
+	/*!
+	@brief ȡδrun()ʼи׶д(˿вʱͳ)
+	*/
+	idle_stats idleStats();
+#ifdef ENABLE_SCHEDULER_STATS
+	/*!
+	@brief ȡδrun()ʼ̵߳ͳƣactorеãҪֹͣ
+	*/
+	std::vector<thread_stats> stats();
+#endif
 private:
 	friend my_actor;
 	static void install();
 	static void uninstall();
+private:
+	size_t sharedRun();
+	template <typename Poll>
+	bool idleSpin(Poll&& poll);
+	size_t stealRun(steal_worker* worker);
+	StrandEx_* stealPop(steal_worker* worker);
+	void stealSchedule(StrandEx_* strand);
 private:
 	bool _opend;
 	size_t _poolSize;
@@ -182,8 +288,23 @@ private:
 	std::atomic<long long> _runCount;
 	std::set<run_thread::thread_id> _threadsID;
 	std::list<run_thread*> _runThreads;
+	std::vector<int> _cpuList;
 	boost::asio::io_service _ios;
 	boost::asio::io_service::work* _runLock;
+	schedule_mode _scheduleMode;
+	std::vector<steal_worker*> _stealWorkers;
+	std::atomic<size_t> _stealNumber;
+	std::atomic<size_t> _stealHome;
+	std::atomic<size_t> _idleNumber;
+	std::atomic<int> _idleSpinUs;
+	std::atomic<int> _idleYieldUs;
+	std::atomic<unsigned long long> _spinWakeCount;
+	std::atomic<unsigned long long> _yieldWakeCount;
+	std::atomic<unsigned long long> _parkCount;
+#ifdef ENABLE_SCHEDULER_STATS
+	std::vector<stats_slot*> _statsSlots;
+	size_t _statsNumber;
+#endif
 #ifdef WIN32
 	std::vector<HANDLE> _handleList;
 #elif __linux__
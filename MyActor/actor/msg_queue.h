@@ -352,6 +352,7 @@ public:
 	struct face
 	{
 		friend op_queue;
+		friend class mpsc_op_queue;
 	private:
 		face* _next;
 	};
@@ -470,6 +471,108 @@ private:
 };
 //////////////////////////////////////////////////////////////////////////
 
+/*!
+@brief ߵУռñǣ
+пʱpushֱӻռȨռȡ߳ͶݵĽڵ
+*/
+class mpsc_op_queue
+{
+public:
+	mpsc_op_queue()
+		:_head(NULL) {}
+
+	~mpsc_op_queue()
+	{
+		assert(!_head);
+	}
+public:
+	/*!
+	@brief Ͷһڵ
+	@return true пУ߻ռȨڵδӣfalse ڵ
+	*/
+	bool push(op_queue::face* newFace)
+	{
+		op_queue::face* head = _head.load(std::memory_order_relaxed);
+		while (true)
+		{
+			if (!head)
+			{
+				if (_head.compare_exchange_weak(head, locked_sign(), std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			else
+			{
+				newFace->_next = head;
+				if (_head.compare_exchange_weak(head, newFace, std::memory_order_release, std::memory_order_relaxed))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	/*!
+	@brief пʱռȨ
+	*/
+	bool try_lock()
+	{
+		op_queue::face* head = NULL;
+		return _head.compare_exchange_strong(head, locked_sign(), std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	/*!
+	@brief ûдڵʱͷռȨռߵã
+	*/
+	bool try_unlock()
+	{
+		op_queue::face* head = locked_sign();
+		return _head.compare_exchange_strong(head, NULL, std::memory_order_release, std::memory_order_relaxed);
+	}
+
+	/*!
+	@brief Ͷ˳ȡдڵ׷ӵoutβռߵã
+	*/
+	bool pop_all(op_queue& out)
+	{
+		if (locked_sign() == _head.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+		op_queue::face* it = _head.exchange(locked_sign(), std::memory_order_acquire);
+		op_queue temp;
+		while (locked_sign() != it)
+		{
+			op_queue::face* const next = it->_next;
+			temp.push_front(it);
+			it = next;
+		}
+		out.push_back(temp);
+		return true;
+	}
+
+	bool locked() const
+	{
+		return NULL != _head.load(std::memory_order_acquire);
+	}
+
+	bool waiting_empty() const
+	{
+		op_queue::face* const head = _head.load(std::memory_order_acquire);
+		return !head || locked_sign() == head;
+	}
+private:
+	op_queue::face* locked_sign() const
+	{//ַΪռñǣκνڵͻ
+		return (op_queue::face*)this;
+	}
+private:
+	std::atomic<op_queue::face*> _head;
+	NONE_COPY(mpsc_op_queue);
+};
+//////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 class fixed_buffer
 {
@@ -653,6 +756,278 @@ public:
 	fixed_buffer(size_t maxSize)
 		:fixed_buffer<void>(maxSize){}
 };
+
+/*!
+@brief λ壬洢ռ䰴2ݶ룬ͷβõ붨λ
+*/
+template <typename T>
+class ring_buffer
+{
+	struct node
+	{
+		__space_align char space[sizeof(T)];
+	};
+public:
+	ring_buffer(size_t maxSize)
+	{
+		assert(0 != maxSize);
+		size_t capacity = 1;
+		while (capacity < maxSize)
+		{
+			capacity <<= 1;
+		}
+		_head = 0;
+		_tail = 0;
+		_mask = capacity - 1;
+		_maxSize = maxSize;
+		_buffer = (node*)malloc(sizeof(node)*capacity);
+	}
+
+	~ring_buffer()
+	{
+		clear();
+		free(_buffer);
+	}
+public:
+	size_t size() const
+	{
+		return _tail - _head;
+	}
+
+	size_t max_size() const
+	{
+		return _maxSize;
+	}
+
+	bool empty() const
+	{
+		return _tail == _head;
+	}
+
+	bool full() const
+	{
+		return _maxSize == _tail - _head;
+	}
+
+	void clear()
+	{
+		while (!empty())
+		{
+			pop_front();
+		}
+		_head = 0;
+		_tail = 0;
+	}
+
+	T& front()
+	{
+		assert(!empty());
+		return *as_ptype<T>(_buffer[_head & _mask].space);
+	}
+
+	void pop_front()
+	{
+		assert(!empty());
+		node& frontNode = _buffer[_head++ & _mask];
+		as_ptype<T>(frontNode.space)->~T();
+#if (_DEBUG || DEBUG)
+		memset(frontNode.space, 0xcf, sizeof(frontNode.space));
+#endif
+	}
+
+	template <typename... Args>
+	void push_back(Args&&... args)
+	{
+		assert(!full());
+		new(_buffer[_tail & _mask].space)T(std::forward<Args>(args)...);
+		_tail++;
+	}
+private:
+	size_t _head;
+	size_t _tail;
+	size_t _mask;
+	size_t _maxSize;
+	node* _buffer;
+	NONE_COPY(ring_buffer);
+};
+
+template <>
+class ring_buffer<void_type> : public fixed_buffer<void>
+{
+public:
+	ring_buffer(size_t maxSize)
+		:fixed_buffer<void>(maxSize){}
+};
+
+template <>
+class ring_buffer<std::tuple<void_type>> : public fixed_buffer<void>
+{
+public:
+	ring_buffer(size_t maxSize)
+		:fixed_buffer<void>(maxSize){}
+};
+
+#ifndef MPMC_CACHE_LINE_SIZE
+#define MPMC_CACHE_LINE_SIZE 64
+#endif
+
+/*!
+@brief ߶߻ζУÿλţ2ݶ루С2
+*/
+template <typename T>
+class mpmc_ring_queue
+{
+	struct node
+	{
+		std::atomic<size_t> _seq;
+		__space_align char space[sizeof(T)];
+	};
+public:
+	mpmc_ring_queue(size_t maxSize)
+	{
+		assert(0 != maxSize);
+		size_t capacity = 2;
+		while (capacity < maxSize)
+		{
+			capacity <<= 1;
+		}
+		_mask = capacity - 1;
+		_buffer = (node*)malloc(sizeof(node)*capacity);
+		for (size_t i = 0; i < capacity; i++)
+		{
+			new(&_buffer[i]._seq)std::atomic<size_t>(i);
+		}
+		_pushPos = 0;
+		_popPos = 0;
+	}
+
+	~mpmc_ring_queue()
+	{
+		clear();
+		for (size_t i = 0; i <= _mask; i++)
+		{
+			typedef std::atomic<size_t> seq_type;
+			_buffer[i]._seq.~seq_type();
+		}
+		free(_buffer);
+	}
+public:
+	size_t max_size() const
+	{
+		return _mask + 1;
+	}
+
+	/*!
+	@brief ֵʱο
+	*/
+	size_t size() const
+	{
+		const size_t popPos = _popPos.load(std::memory_order_acquire);
+		const size_t pushPos = _pushPos.load(std::memory_order_acquire);
+		return pushPos > popPos ? pushPos - popPos : 0;
+	}
+
+	bool empty() const
+	{
+		const size_t pos = _popPos.load(std::memory_order_acquire);
+		return (intptr_t)(_buffer[pos & _mask]._seq.load(std::memory_order_acquire) - (pos + 1)) < 0;
+	}
+
+	bool full() const
+	{
+		const size_t pos = _pushPos.load(std::memory_order_acquire);
+		return (intptr_t)(_buffer[pos & _mask]._seq.load(std::memory_order_acquire) - pos) < 0;
+	}
+
+	void clear()
+	{
+		while (try_pop_front())
+		{
+		}
+	}
+
+	/*!
+	@brief ӣʱfalseᱻƶ
+	*/
+	template <typename... Args>
+	bool try_push_back(Args&&... args)
+	{
+		size_t pos = _pushPos.load(std::memory_order_relaxed);
+		node* cell;
+		while (true)
+		{
+			cell = &_buffer[pos & _mask];
+			const intptr_t dif = (intptr_t)(cell->_seq.load(std::memory_order_acquire) - pos);
+			if (0 == dif)
+			{
+				if (_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (dif < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = _pushPos.load(std::memory_order_relaxed);
+			}
+		}
+		new(cell->space)T(std::forward<Args>(args)...);
+		cell->_seq.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+	@brief ӣпʱfalse
+	*/
+	template <typename Handler>
+	bool try_pop_front(Handler&& h)
+	{
+		size_t pos = _popPos.load(std::memory_order_relaxed);
+		node* cell;
+		while (true)
+		{
+			cell = &_buffer[pos & _mask];
+			const intptr_t dif = (intptr_t)(cell->_seq.load(std::memory_order_acquire) - (pos + 1));
+			if (0 == dif)
+			{
+				if (_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (dif < 0)
+			{
+				return false;
+			}
+			else
+			{
+				pos = _popPos.load(std::memory_order_relaxed);
+			}
+		}
+		T msg(std::move(*as_ptype<T>(cell->space)));
+		as_ptype<T>(cell->space)->~T();
+		cell->_seq.store(pos + _mask + 1, std::memory_order_release);
+		h(msg);
+		return true;
+	}
+
+	bool try_pop_front()
+	{
+		return try_pop_front([](T&){});
+	}
+private:
+	node* _buffer;
+	size_t _mask;
+	char _pad0[MPMC_CACHE_LINE_SIZE];
+	std::atomic<size_t> _pushPos;
+	char _pad1[MPMC_CACHE_LINE_SIZE];
+	std::atomic<size_t> _popPos;
+	char _pad2[MPMC_CACHE_LINE_SIZE];
+	NONE_COPY(mpmc_ring_queue);
+};
 //////////////////////////////////////////////////////////////////////////
 
 template <typename T, typename _All = pool_alloc<> >
@@ -1158,4 +1533,361 @@ public:
 	}
 };
 
+//ʱ̶ֿ(΢)
+#ifndef TIMER_WHEEL_TICK_US
+#define TIMER_WHEEL_TICK_US 1000
+#endif
+
+static_assert(0 < TIMER_WHEEL_TICK_US, "");
+
+/*!
+@brief ֲϣʱ֣4x256ۣ/ɾO(1)
+0ڰʱ򣬵˳msg_multimapһ£
+ʱ䲻СѲֵʱֱ׷ӵβ(ͬ_extMaxTick)ڲǰ
+*/
+template <typename Tval, typename _All = mem_alloc<>>
+class msg_timer_wheel
+{
+	enum
+	{
+		WHEEL_LEVELS = 4,
+		WHEEL_SLOTS = 256,
+		OVERFLOW_SLOT = WHEEL_LEVELS * WHEEL_SLOTS
+	};
+
+	struct node
+	{
+		template <typename Arg>
+		node(long long et, Arg&& val)
+			:first(et), second(std::forward<Arg>(val)) {}
+
+		const long long first;
+		Tval second;
+		node* _prev;
+		node* _next;
+		int _slot;
+	};
+
+	struct slot
+	{
+		node* _head;
+		node* _tail;
+	};
+
+	typedef typename _All::template rebind<node>::other allocator;
+public:
+	typedef node* iterator;
+public:
+	explicit msg_timer_wheel(size_t poolSize = sizeof(void*), long long tickUs = TIMER_WHEEL_TICK_US)
+		:_alloc(poolSize), _tickUs(tickUs), _currTick(0), _extMaxTick(0), _size(0)
+	{
+		assert(tickUs > 0);
+		memset(_slots, 0, sizeof(_slots));
+		memset(_bitmap, 0, sizeof(_bitmap));
+	}
+
+	~msg_timer_wheel()
+	{
+		clear();
+	}
+public:
+	/*!
+	@brief һʱΪetĽڵ
+	@param ct ǰʱ䣬ʱΪʱУ׼
+	*/
+	template <typename Arg>
+	iterator insert(long long et, long long ct, Arg&& val)
+	{
+		if (!_size)
+		{
+			_currTick = to_tick(ct);
+			_extMaxTick = et;
+		}
+		node* newNode = NULL;
+		BEGIN_CHECK_EXCEPTION;
+		newNode = new(_alloc.allocate())node(et, std::forward<Arg>(val));
+		END_CHECK_EXCEPTION;
+		link(newNode);
+		_size++;
+		return newNode;
+	}
+
+	void erase(iterator it)
+	{
+		assert(_size);
+		unlink(it);
+		it->~node();
+		_alloc.deallocate(it);
+		_size--;
+	}
+
+	/*!
+	@brief ƽʱֵctһѵ(first <= ct)Ľڵ㣬ûзNULL
+	*/
+	iterator expired(long long ct)
+	{
+		const unsigned long long t = to_tick(ct);
+		while (_size)
+		{
+			const int idx = find_bit(_bitmap[0], (int)(_currTick & (WHEEL_SLOTS - 1)));
+			if (-1 != idx)
+			{
+				const unsigned long long st = (_currTick & ~(unsigned long long)(WHEEL_SLOTS - 1)) | idx;
+				if (st > t)
+				{
+					break;
+				}
+				_currTick = st;
+				node* const head = _slots[idx]._head;
+				return head->first <= ct ? head : NULL;
+			}
+			const unsigned long long nt = next_cascade();
+			if (nt > t)
+			{
+				break;
+			}
+			_currTick = nt;
+			cascade();
+		}
+		if (t > _currTick)
+		{
+			_currTick = t;
+		}
+		return NULL;
+	}
+
+	/*!
+	@brief һҪѵʱ䣬ĳڵĵʱ䣬ҲǸ߲λչʱ
+	*/
+	long long next_deadline()
+	{
+		assert(_size);
+		const int idx = find_bit(_bitmap[0], (int)(_currTick & (WHEEL_SLOTS - 1)));
+		if (-1 != idx)
+		{
+			return _slots[idx]._head->first;
+		}
+		return (long long)next_cascade() * _tickUs;
+	}
+
+	size_t size() const
+	{
+		return _size;
+	}
+
+	bool empty() const
+	{
+		return !_size;
+	}
+
+	void clear()
+	{
+		for (int i = 0; i <= OVERFLOW_SLOT; i++)
+		{
+			while (_slots[i]._head)
+			{
+				erase(_slots[i]._head);
+			}
+		}
+		assert(!_size);
+	}
+private:
+	unsigned long long to_tick(long long us) const
+	{
+		return us > 0 ? (unsigned long long)(us / _tickUs) : 0;
+	}
+
+	static int find_bit(const unsigned long long* bitmap, int from)
+	{
+		for (int w = from >> 6; w < WHEEL_SLOTS / 64; w++)
+		{
+			unsigned long long bits = bitmap[w];
+			if (w == (from >> 6))
+			{
+				bits &= (unsigned long long)-1 << (from & 63);
+			}
+			if (bits)
+			{
+#ifdef __GNUG__
+				return (w << 6) + __builtin_ctzll(bits);
+#else
+				int n = 0;
+				while (!(bits & 1))
+				{
+					bits >>= 1;
+					n++;
+				}
+				return (w << 6) + n;
+#endif
+			}
+		}
+		return -1;
+	}
+
+	void link(node* newNode)
+	{
+		unsigned long long t = to_tick(newNode->first);
+		if (t < _currTick)
+		{//ѹڵķŵǰ
+			t = _currTick;
+		}
+		const unsigned long long diff = t ^ _currTick;
+		if (diff < WHEEL_SLOTS)
+		{
+			const int idx = (int)(t & (WHEEL_SLOTS - 1));
+			slot& sl = _slots[idx];
+			node* prev = sl._tail;
+			if (newNode->first >= _extMaxTick)
+			{//нڵ㣬ֱ׷ӵβ
+				assert(!prev || prev->first <= newNode->first);
+				_extMaxTick = newNode->first;
+			}
+			else
+			{
+				while (prev && prev->first > newNode->first)
+				{
+					prev = prev->_prev;
+				}
+			}
+			newNode->_slot = idx;
+			newNode->_prev = prev;
+			if (prev)
+			{
+				newNode->_next = prev->_next;
+				prev->_next = newNode;
+			}
+			else
+			{
+				newNode->_next = sl._head;
+				sl._head = newNode;
+			}
+			if (newNode->_next)
+			{
+				newNode->_next->_prev = newNode;
+			}
+			else
+			{
+				sl._tail = newNode;
+			}
+			_bitmap[0][idx >> 6] |= (unsigned long long)1 << (idx & 63);
+			return;
+		}
+		int slotID = OVERFLOW_SLOT;
+		for (int level = 1; level < WHEEL_LEVELS; level++)
+		{
+			if (diff < (unsigned long long)1 << (8 * (level + 1)))
+			{
+				const int idx = (int)((t >> (8 * level)) & (WHEEL_SLOTS - 1));
+				slotID = level * WHEEL_SLOTS + idx;
+				_bitmap[level][idx >> 6] |= (unsigned long long)1 << (idx & 63);
+				break;
+			}
+		}
+		slot& sl = _slots[slotID];
+		newNode->_slot = slotID;
+		newNode->_next = NULL;
+		newNode->_prev = sl._tail;
+		if (sl._tail)
+		{
+			sl._tail->_next = newNode;
+		}
+		else
+		{
+			sl._head = newNode;
+		}
+		sl._tail = newNode;
+	}
+
+	void unlink(node* oldNode)
+	{
+		slot& sl = _slots[oldNode->_slot];
+		if (oldNode->_prev)
+		{
+			oldNode->_prev->_next = oldNode->_next;
+		}
+		else
+		{
+			sl._head = oldNode->_next;
+		}
+		if (oldNode->_next)
+		{
+			oldNode->_next->_prev = oldNode->_prev;
+		}
+		else
+		{
+			sl._tail = oldNode->_prev;
+		}
+		if (!sl._head && OVERFLOW_SLOT != oldNode->_slot)
+		{
+			const int level = oldNode->_slot / WHEEL_SLOTS;
+			const int idx = oldNode->_slot % WHEEL_SLOTS;
+			_bitmap[level][idx >> 6] &= ~((unsigned long long)1 << (idx & 63));
+		}
+	}
+
+	/*!
+	@brief 0պһнڵչĸ߲λʼ̶
+	*/
+	unsigned long long next_cascade() const
+	{
+		for (int level = 1; level < WHEEL_LEVELS; level++)
+		{
+			const int shift = 8 * level;
+			const int idx = find_bit(_bitmap[level], (int)((_currTick >> shift) & (WHEEL_SLOTS - 1)) + 1);
+			if (-1 != idx)
+			{
+				return (_currTick & ~(((unsigned long long)1 << (shift + 8)) - 1)) | ((unsigned long long)idx << shift);
+			}
+		}
+		return ((_currTick >> 32) + 1) << 32;
+	}
+
+	/*!
+	@brief ǰ̶ȿ߲߽磬ӸߵͰѶӦλ·䵽Ͳ
+	*/
+	void cascade()
+	{
+		if (!(_currTick & 0xFFFFFFFF))
+		{
+			relink(OVERFLOW_SLOT);
+		}
+		for (int level = WHEEL_LEVELS - 1; level > 0; level--)
+		{
+			const int shift = 8 * level;
+			if (!(_currTick & (((unsigned long long)1 << shift) - 1)))
+			{
+				relink(level * WHEEL_SLOTS + (int)((_currTick >> shift) & (WHEEL_SLOTS - 1)));
+			}
+		}
+	}
+
+	void relink(int slotID)
+	{
+		node* it = _slots[slotID]._head;
+		_slots[slotID]._head = NULL;
+		_slots[slotID]._tail = NULL;
+		if (OVERFLOW_SLOT != slotID)
+		{
+			const int level = slotID / WHEEL_SLOTS;
+			const int idx = slotID % WHEEL_SLOTS;
+			_bitmap[level][idx >> 6] &= ~((unsigned long long)1 << (idx & 63));
+		}
+		while (it)
+		{
+			node* const next = it->_next;
+			link(it);
+			it = next;
+		}
+	}
+private:
+	allocator _alloc;
+	const long long _tickUs;
+	unsigned long long _currTick;
+	long long _extMaxTick;//0ڵ㵽ʱϽ磬ɾʱ
+	size_t _size;
+	slot _slots[OVERFLOW_SLOT + 1];
+	unsigned long long _bitmap[WHEEL_LEVELS][WHEEL_SLOTS / 64];
+	NONE_COPY(msg_timer_wheel);
+};
+
 #endif
\ No newline at end of file
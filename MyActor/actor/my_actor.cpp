@@ -2,18 +2,6 @@
 #include "channel.h"
 #include "bind_qt_run.h"
 #include "generator.h"
-#if (_MSC_VER >= 1900 || (__GNUG__*10 + __GNUC_MINOR__) >= 61)
-#include <shared_mutex>
-typedef std::shared_mutex _shared_mutex;
-#define _shared_lock std::shared_lock
-#define _unique_lock std::unique_lock
-#else
-#include <boost/thread/shared_mutex.hpp>
-#include <boost/thread/locks.hpp>
-typedef boost::shared_mutex _shared_mutex;
-#define _shared_lock boost::shared_lock
-#define _unique_lock boost::unique_lock
-#endif
 #if (WIN32 && __GNUG__)
 #include <fibersapi.h>
 #endif
@@ -30,27 +18,195 @@ static mem_alloc_base* s_checkLostObjAlloc = NULL;
 static mem_alloc_base* s_checkPumpLostObjAlloc = NULL;
 #endif
 
+//auto_stackѧϰ(Ѱַ2)µkeyÿζջ
+#ifndef AUTO_STACK_TABLE_SIZE
+#define AUTO_STACK_TABLE_SIZE 1024
+#endif
+
+//ÿkeyٴʵջͳưٷλ
+#ifndef AUTO_STACK_SAMPLE_LENGTH
+#define AUTO_STACK_SAMPLE_LENGTH 32
+#endif
+
+//ѧϰkeyÿٴջʵһΣ0Ϊز
+#ifndef AUTO_STACK_RESAMPLE_INTERVAL
+#define AUTO_STACK_RESAMPLE_INTERVAL 0
+#endif
+
+static_assert(0 < AUTO_STACK_TABLE_SIZE && 0 == (AUTO_STACK_TABLE_SIZE & (AUTO_STACK_TABLE_SIZE - 1)), "");
+static_assert(0 < AUTO_STACK_SAMPLE_LENGTH, "");
+
+/*!
+@brief auto_stackջߴѧϰѰַĿֻɾ
+actorʱֻֻпջactor˳ʱд
+*/
 struct autoActorStackMng
 {
+	struct stack_slot
+	{
+		std::atomic<size_t> _key;//key+10Ϊλ
+		std::atomic<size_t> _stackSize;//ѧϰջߴ(ֵ)
+		std::atomic<size_t> _createCount;
+		std::atomic<size_t> _sampleCount;
+		std::atomic<unsigned short> _samples[AUTO_STACK_SAMPLE_LENGTH];//ʵջ(ҳ)
+	};
+
+	autoActorStackMng()
+	{
+		for (size_t i = 0; i < AUTO_STACK_TABLE_SIZE; i++)
+		{
+			stack_slot& slot = _table[i];
+			slot._key.store(0, std::memory_order_relaxed);
+			slot._stackSize.store(0, std::memory_order_relaxed);
+			slot._createCount.store(0, std::memory_order_relaxed);
+			slot._sampleCount.store(0, std::memory_order_relaxed);
+			for (size_t j = 0; j < AUTO_STACK_SAMPLE_LENGTH; j++)
+			{
+				slot._samples[j].store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	stack_slot* find(size_t key, bool make)
+	{
+		const size_t k = key + 1;
+		size_t i = (size_t)((unsigned long long)k * 0x9E3779B97F4A7C15ULL >> 40);
+		for (size_t n = 0; n < AUTO_STACK_TABLE_SIZE; n++, i++)
+		{
+			stack_slot& slot = _table[i & (AUTO_STACK_TABLE_SIZE - 1)];
+			size_t ck = slot._key.load(std::memory_order_acquire);
+			if (!ck)
+			{
+				if (!make)
+				{
+					return NULL;
+				}
+				if (slot._key.compare_exchange_strong(ck, k, std::memory_order_acq_rel))
+				{
+					return &slot;
+				}
+			}
+			if (k == ck)
+			{
+				return &slot;
+			}
+		}
+		return NULL;
+	}
+
 	size_t get_stack_size(size_t key)
 	{
-		_shared_lock<_shared_mutex> sl(_mutex);
-		auto it = _table.find(key);
-		if (_table.end() != it)
+		stack_slot* const slot = find(key, false);
+		if (!slot)
 		{
-			return it->second;
+			return 0;
 		}
-		return 0;
+		const size_t ss = slot->_stackSize.load(std::memory_order_relaxed);
+#if (AUTO_STACK_RESAMPLE_INTERVAL > 0)
+		if (ss && 0 == (slot->_createCount.fetch_add(1, std::memory_order_relaxed) + 1) % AUTO_STACK_RESAMPLE_INTERVAL)
+		{//0ջ¼
+			return 0;
+		}
+#endif
+		return ss;
 	}
 
 	void update_stack_size(size_t key, size_t ns)
 	{
-		_unique_lock<_shared_mutex> ul(_mutex);
-		_table[key] = ns;
+		stack_slot* const slot = find(key, true);
+		if (!slot)
+		{
+			return;
+		}
+		const size_t i = slot->_sampleCount.fetch_add(1, std::memory_order_relaxed) % AUTO_STACK_SAMPLE_LENGTH;
+		slot->_samples[i].store((unsigned short)(ns / MEM_PAGE_SIZE), std::memory_order_relaxed);
+		size_t ss = slot->_stackSize.load(std::memory_order_relaxed);
+		while (ss < ns && !slot->_stackSize.compare_exchange_weak(ss, ns, std::memory_order_relaxed)) {}
+	}
+
+	/*!
+	@brief İٷλ(ֽ)sortedΪҳ
+	*/
+	static size_t percentile(const std::vector<unsigned short>& sorted, size_t p)
+	{
+		size_t rank = (p * sorted.size() + 99) / 100;
+		rank = rank ? rank - 1 : 0;
+		return (size_t)sorted[std::min(rank, sorted.size() - 1)] * MEM_PAGE_SIZE;
 	}
 
-	std::map<size_t, size_t> _table;
-	_shared_mutex _mutex;
+	void export_table(std::ostream& out)
+	{
+		std::vector<unsigned short> sorted;
+		for (size_t i = 0; i < AUTO_STACK_TABLE_SIZE; i++)
+		{
+			stack_slot& slot = _table[i];
+			const size_t k = slot._key.load(std::memory_order_acquire);
+			const size_t ss = slot._stackSize.load(std::memory_order_relaxed);
+			if (!k || !ss)
+			{
+				continue;
+			}
+			const size_t sc = std::min(slot._sampleCount.load(std::memory_order_relaxed), (size_t)AUTO_STACK_SAMPLE_LENGTH);
+			sorted.clear();
+			for (size_t j = 0; j < sc; j++)
+			{
+				sorted.push_back(slot._samples[j].load(std::memory_order_relaxed));
+			}
+			out << (k - 1) << " " << ss;
+			if (!sorted.empty())
+			{
+				std::sort(sorted.begin(), sorted.end());
+				out << " " << percentile(sorted, 50) << " " << percentile(sorted, 90) << " " << percentile(sorted, 99);
+			}
+			else
+			{
+				out << " " << ss << " " << ss << " " << ss;
+			}
+			out << " " << sc << "\n";
+		}
+	}
+
+	size_t import_table(std::istream& in, size_t prewarm)
+	{
+		if (prewarm && !context_yield::is_thread_a_fiber())
+		{
+			warning_trace_line("import_auto_stack: prewarm must be called in an io_engine thread, ignored");
+			prewarm = 0;
+		}
+		size_t count = 0;
+		std::string line;
+		while (std::getline(in, line))
+		{
+			std::istringstream ls(line);
+			size_t key = 0, ss = 0;
+			if (!(ls >> key >> ss) || !ss || ss % MEM_PAGE_SIZE || ss > 1024 * 1024)
+			{
+				continue;
+			}
+			stack_slot* const slot = find(key, true);
+			if (!slot)
+			{
+				break;
+			}
+			if (!slot->_sampleCount.load(std::memory_order_relaxed))
+			{
+				update_stack_size(key, ss);
+			}
+			else
+			{
+				size_t oss = slot->_stackSize.load(std::memory_order_relaxed);
+				while (oss < ss && !slot->_stackSize.compare_exchange_weak(oss, ss, std::memory_order_relaxed)) {}
+			}
+			if (prewarm)
+			{
+				ContextPool_::prewarm(slot->_stackSize.load(std::memory_order_relaxed), prewarm);
+			}
+			count++;
+		}
+		return count;
+	}
+
+	stack_slot _table[AUTO_STACK_TABLE_SIZE];
 };
 
 struct shared_initer 
@@ -64,7 +220,6 @@ static autoActorStackMng* s_autoActorStackMng = NULL;
 mem_alloc_base* shared_bool::_sharedBoolAlloc = NULL;
 std::recursive_mutex* TraceMutex_::_mutex = NULL;
 std::atomic<my_actor::id>* my_actor::_actorIDCount = NULL;
-msg_map_shared_alloc<my_actor::msg_pool_status::id_key, std::shared_ptr<my_actor::msg_pool_status::pck_base> >::shared_node_alloc* my_actor::msg_pool_status::_msgTypeMapAll = NULL;
 
 void my_actor::install()
 {
@@ -90,7 +245,6 @@ void my_actor::install()
 		shared_bool::_sharedBoolAlloc = make_shared_space_alloc<bool, mem_alloc_tls<SHARED_BOOL_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](bool*){});
 		my_actor::_actorIDCount = new std::atomic<my_actor::id>(0);
 		s_shared_initer._actorIDCount = my_actor::_actorIDCount;
-		my_actor::msg_pool_status::_msgTypeMapAll = new msg_map_shared_alloc<my_actor::msg_pool_status::id_key, std::shared_ptr<my_actor::msg_pool_status::pck_base> >::shared_node_alloc(MEM_POOL_LENGTH);
 		generator::install(my_actor::_actorIDCount);
 	}
 }
@@ -119,7 +273,6 @@ void my_actor::install(const shared_initer* initer)
 		shared_bool::_sharedBoolAlloc = make_shared_space_alloc<bool, mem_alloc_tls<SHARED_BOOL_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](bool*){});
 		my_actor::_actorIDCount = initer->_actorIDCount;
 		s_shared_initer._actorIDCount = initer->_actorIDCount;
-		my_actor::msg_pool_status::_msgTypeMapAll = new msg_map_shared_alloc<my_actor::msg_pool_status::id_key, std::shared_ptr<my_actor::msg_pool_status::pck_base> >::shared_node_alloc(MEM_POOL_LENGTH);
 		generator::install(my_actor::_actorIDCount);
 	}
 }
@@ -137,8 +290,6 @@ void my_actor::uninstall()
 			delete my_actor::_actorIDCount;
 		s_shared_initer._actorIDCount = NULL;
 		my_actor::_actorIDCount = NULL;
-		delete my_actor::msg_pool_status::_msgTypeMapAll;
-		my_actor::msg_pool_status::_msgTypeMapAll = NULL;
 		delete s_autoActorStackMng;
 		s_autoActorStackMng = NULL;
 #ifdef ENABLE_CHECK_LOST
@@ -170,6 +321,7 @@ const shared_initer* my_actor::get_initer()
 
 void my_actor::tls_init()
 {
+	ContextPool_::tls_init();
 	shared_bool::_sharedBoolAlloc->tls_init();
 #ifdef ENABLE_CHECK_LOST
 	s_checkLostObjAlloc->tls_init();
@@ -184,6 +336,7 @@ void my_actor::tls_uninit()
 	s_checkLostObjAlloc->tls_uninit();
 #endif
 	shared_bool::_sharedBoolAlloc->tls_uninit();
+	ContextPool_::tls_uninit();
 }
 
 void** MemAllocTls_::getTlsValueBuff()
@@ -1469,6 +1622,7 @@ public:
 	void exit_notify()
 	{
 		DEBUG_OPERATION(size_t yc = _actor.yield_count());
+		EVENT_TRACE(et_actor_quit, _actor._selfID);
 		_actor._exited = true;
 		while (!_actor._suspendResumeQueue.empty())
 		{
@@ -1746,6 +1900,16 @@ public:
 		sigAction.sa_flags = SA_SIGINFO | SA_ONSTACK;
 		sigAction.sa_sigaction = [](int signum, siginfo_t* info, void* ptr)
 		{
+#ifdef ENABLE_GROWABLE_STACK
+			{
+				//չύջռִ
+				my_actor* const self = my_actor::self_actor();
+				if (self && context_yield::grow_context(self->_actorPull->_coroInfo, info->si_addr))
+				{
+					return;
+				}
+			}
+#endif
 			TraceMutex_ mt;
 			ucontext_t* const ucontext = (ucontext_t*)ptr;
 #if (__i386__ || __x86_64__)
@@ -1850,6 +2014,7 @@ my_actor::my_actor()
 	_checkStackFree = false;
 #endif
 	_selfID = ++(*_actorIDCount);
+	EVENT_TRACE(et_actor_create, _selfID);
 	_actorKey = -1;
 	_lockQuit = 0;
 	_lockSuspend = 0;
@@ -1930,6 +2095,18 @@ actor_handle my_actor::create(shared_strand actorStrand, main_func mainFunc, siz
 	return newActor;
 }
 
+void my_actor::export_auto_stack(std::ostream& out)
+{
+	assert(s_autoActorStackMng);
+	s_autoActorStackMng->export_table(out);
+}
+
+size_t my_actor::import_auto_stack(std::istream& in, size_t prewarm)
+{
+	assert(s_autoActorStackMng);
+	return s_autoActorStackMng->import_table(in, prewarm);
+}
+
 actor_handle my_actor::create(shared_strand actorStrand, AutoStackActorFace_&& wrapActor)
 {
 	actor_pull_type* pull = NULL;
@@ -2511,6 +2688,7 @@ void my_actor::reset_yield()
 
 void my_actor::run()
 {
+	EVENT_TRACE(et_actor_run, _selfID);
 	_strand->try_tick(std::bind([](const actor_handle& shared_this)
 	{
 		my_actor* const self = shared_this.get();
@@ -3188,6 +3366,7 @@ void my_actor::run_one()
 
 void my_actor::pull_yield_tls()
 {
+	EVENT_TRACE_SCOPE(et_actor_resume, et_actor_yield, _selfID);
 #if ((__linux__ && (defined ENABLE_DUMP_STACK || (defined CHECK_SELF))) || (WIN32 && (_WIN32_WINNT < 0x0502) && (defined CHECK_SELF)))
 	void*& tlsVal = io_engine::getTlsValueRef(ACTOR_TLS_INDEX);
 	void* old = tlsVal;
@@ -2,6 +2,7 @@
 #define __MY_ACTOR_H
 
 #include <list>
+#include <vector>
 #include <functional>
 #include "io_engine.h"
 #include "run_strand.h"
@@ -1024,6 +1025,7 @@ private:
 		res->_losted = false;
 		res->_waitConnect = false;
 		res->_checkLost = checkLost;
+		res->_poolMore = false;
 		res->_pumpCount = 0;
 		res->_dstRec = NULL;
 		res->_hostActor = hostActor;
@@ -1031,12 +1033,13 @@ private:
 		return res;
 	}
 
-	void receiver(msg_type&& msg)
+	void receiver(msg_type&& msg, bool more)
 	{
 		if (Parent::_hostActor)
 		{
 			assert(!_hasMsg);
 			_pumpCount++;
+			_poolMore = more;
 			if (_dstRec)
 			{
 				_dstRec->move_from(std::move(msg));
@@ -1087,17 +1090,20 @@ private:
 		}
 	}
 
-	void receive_msg(msg_type&& msg, actor_handle&& hostActor)
+	/*!
+	@param more ϢǷ񻹻кϢ
+	*/
+	void receive_msg(msg_type&& msg, actor_handle&& hostActor, bool more = false)
 	{
 		if (_strand->running_in_this_thread())
 		{
-			receiver(std::move(msg));
+			receiver(std::move(msg), more);
 		}
 		else
 		{
-			_strand->post(std::bind([](const actor_handle& hostActor, const std::shared_ptr<MsgPump_> sharedThis, msg_type& msg)
+			_strand->post(std::bind([more](const actor_handle& hostActor, const std::shared_ptr<MsgPump_> sharedThis, msg_type& msg)
 			{
-				sharedThis->receiver(std::move(msg));
+				sharedThis->receiver(std::move(msg), more);
 			}, std::move(hostActor), _weakThis.lock(), std::move(msg)));
 		}
 	}
@@ -1146,8 +1152,10 @@ private:
 		{
 			bool wait = false;
 			bool losted = false;
-			if (_pumpHandler.try_pump(_hostActor, dst, _pumpCount, wait, losted))
+			bool more = false;
+			if (_pumpHandler.try_pump(_hostActor, dst, _pumpCount, wait, losted, more))
 			{
+				_poolMore = more;
 #ifdef ENABLE_CHECK_LOST
 				if (wait)
 				{
@@ -1184,6 +1192,33 @@ private:
 		return false;
 	}
 
+	template <typename Dst>
+	size_t try_read_many(Dst& dst, size_t n)
+	{
+		assert(_strand->running_in_this_thread());
+		assert(!_dstRec);
+		assert(!_waiting);
+		size_t count = 0;
+		if (n && _hasMsg)
+		{
+			_hasMsg = false;
+			dst.push_back(std::move(*as_ptype<msg_type>(_msgSpace)));
+			as_ptype<msg_type>(_msgSpace)->~msg_type();
+			count++;
+		}
+#ifdef ENABLE_CHECK_LOST
+		if (count < n && _poolMore && !_losted && !_pumpHandler.empty())
+#else
+		if (count < n && _poolMore && !_pumpHandler.empty())
+#endif
+		{//ֻϴȡϢʱϢллȥȡϢΪʱstrandл
+			bool more = false;
+			count += _pumpHandler.try_pump_many(_hostActor, dst, n - count, _pumpCount, more);
+			_poolMore = more;
+		}
+		return count;
+	}
+
 	size_t size()
 	{
 		assert(_strand->running_in_this_thread());
@@ -1219,6 +1254,7 @@ private:
 		assert(_hostActor);
 		_pumpHandler = std::forward<PumpHandler>(pumpHandler);
 		_pumpCount = 0;
+		_poolMore = false;
 		if (_waiting)
 		{
 			_pumpHandler.start_pump(_pumpCount);
@@ -1271,6 +1307,7 @@ private:
 		_checkDis = false;
 		_losted = false;
 		_checkLost = false;
+		_poolMore = false;
 		_pumpHandler.clear();
 		Parent::_hostActor = NULL;
 	}
@@ -1293,6 +1330,7 @@ private:
 	bool _checkDis : 1;
 	bool _checkLost : 1;
 	bool _losted : 1;
+	bool _poolMore : 1;
 };
 
 class MsgPoolBase_
@@ -1423,7 +1461,7 @@ class MsgPool_ : public MsgPoolBase_
 						else
 #endif
 						{
-							_msgPump->receive_msg(std::move(mt_.get()), std::move(hostActor));
+							_msgPump->receive_msg(std::move(mt_.get()), std::move(hostActor), !msgBuff.empty());
 						}
 					}
 					else
@@ -1460,10 +1498,10 @@ class MsgPool_ : public MsgPoolBase_
 			}
 		}
 
-		bool try_pump(my_actor* host, dst_receiver& dst, unsigned char pumpID, bool& wait, bool& losted)
+		bool try_pump(my_actor* host, dst_receiver& dst, unsigned char pumpID, bool& wait, bool& losted, bool& more)
 		{
 			assert(_thisPool);
-			return ActorFunc_::send<bool>(host, _thisPool->_strand, std::bind([&dst, &wait, &losted, pumpID](pump_handler& pump)->bool
+			return ActorFunc_::send<bool>(host, _thisPool->_strand, std::bind([&dst, &wait, &losted, &more, pumpID](pump_handler& pump)->bool
 			{
 				bool ok = false;
 				auto& thisPool_ = pump._thisPool;
@@ -1488,6 +1526,7 @@ class MsgPool_ : public MsgPoolBase_
 								msgBuff.pop_front();
 								ok = true;
 							}
+							more = !msgBuff.empty();
 						}
 					}
 					else
@@ -1502,6 +1541,35 @@ class MsgPool_ : public MsgPoolBase_
 			}, *this));
 		}
 
+		template <typename Dst>
+		size_t try_pump_many(my_actor* host, Dst& dst, size_t n, unsigned char pumpID, bool& more)
+		{
+			assert(_thisPool);
+			return ActorFunc_::send<size_t>(host, _thisPool->_strand, std::bind([&dst, &more, n, pumpID](pump_handler& pump)->size_t
+			{
+				size_t count = 0;
+				auto& thisPool_ = pump._thisPool;
+				if (pump._msgPump == thisPool_->_msgPump && pumpID == thisPool_->_sendCount)
+				{//ϢڷϢʱԽȡϢ
+					auto& msgBuff = thisPool_->_msgBuff;
+					while (count < n && !msgBuff.empty())
+					{
+#ifdef ENABLE_CHECK_LOST
+						if (!msgBuff.front()._isMsg)
+						{//ʧһpump_msg
+							break;
+						}
+#endif
+						dst.push_back(std::move(msgBuff.front().get()));
+						msgBuff.pop_front();
+						count++;
+					}
+					more = !msgBuff.empty();
+				}
+				return count;
+			}, *this));
+		}
+
 		size_t size(my_actor* host, unsigned char pumpID)
 		{
 			assert(_thisPool);
@@ -1636,6 +1704,50 @@ private:
 		}
 	}
 
+	void send_msgs(std::vector<msg_type>& msgs, actor_handle&& hostActor)
+	{
+		if (_closed || msgs.empty()) return;
+
+		auto it = msgs.begin();
+		if (_waiting)
+		{//ȻϢٻϢãϢÿreceive_msgֱӻָ
+			_waiting = false;
+			assert(_msgPump);
+			assert(_msgBuff.empty());
+			_sendCount++;
+			msg_type first(std::move(*it));
+			for (++it; msgs.end() != it; ++it)
+			{
+				assert(_msgBuff.size() < _msgBuff.fixed_size());
+				_msgBuff.push_back(std::move(*it));
+			}
+			_msgPump->receive_msg(std::move(first), std::move(hostActor), !_msgBuff.empty());
+			return;
+		}
+		for (; msgs.end() != it; ++it)
+		{
+			assert(_msgBuff.size() < _msgBuff.fixed_size());
+			_msgBuff.push_back(std::move(*it));
+		}
+	}
+
+	void push_msgs(std::vector<msg_type>&& msgs, const actor_handle& hostActor)
+	{
+		if (_closed) return;
+
+		if (_strand->running_in_this_thread())
+		{
+			send_msgs(msgs, ActorFunc_::shared_from_this(hostActor.get()));
+		}
+		else
+		{
+			_strand->post(std::bind([](actor_handle& hostActor, const std::shared_ptr<MsgPool_>& sharedThis, std::vector<msg_type>& msgs)
+			{
+				sharedThis->send_msgs(msgs, std::move(hostActor));
+			}, hostActor, _weakThis.lock(), std::move(msgs)));
+		}
+	}
+
 	void _lost_msg(actor_handle&& hostActor)
 	{
 		if (_closed) return;
@@ -2044,6 +2156,22 @@ public:
 		_msgPool->push_msg(_hostActor);
 	}
 
+	/*!
+	@brief ͶϢϢֻһstrandл
+	*/
+	void post_msgs(std::vector<std::tuple<TYPE_PIPE(ARGS)...>>&& msgs) const
+	{
+		static_assert(sizeof...(ARGS) != 0, "");
+		assert(!empty());
+		_msgPool->push_msgs(std::move(msgs), _hostActor);
+	}
+
+	template <typename Iter>
+	void post_msgs(Iter first, Iter last) const
+	{
+		post_msgs(std::vector<std::tuple<TYPE_PIPE(ARGS)...>>(first, last));
+	}
+
 	std::function<void(ARGS...)> case_func() const
 	{
 		return std::function<void(ARGS...)>(*this);
@@ -4466,9 +4594,7 @@ class my_actor : public ActorTimerFace_
 		};
 #endif
 
-		msg_pool_status()
-			:_msgTypeMap(*_msgTypeMapAll) {}
-
+		msg_pool_status() {}
 		~msg_pool_status() {}
 
 		struct pck_base
@@ -4579,16 +4705,135 @@ class my_actor : public ActorTimerFace_
 			NONE_COPY(pck)
 		};
 
+		/*!
+		@brief ϢͱĿʱǶactor(ȫַ)ֵֿţֻɨ飻
+		رչпĿ룬Աʹ±꣬ҲĿÿԽyield
+		*/
+		class msg_type_table
+		{
+			typedef std::shared_ptr<pck_base> value_type;
+			enum { inline_size = 4 };
+		public:
+			msg_type_table()
+				:_size(0), _capacity(inline_size), _keys(_inlineKeys), _values((value_type*)_inlineValues) {}
+
+			~msg_type_table()
+			{
+				clear();
+				if (_keys != _inlineKeys)
+				{
+					free(_keys);
+					free(_values);
+				}
+			}
+
+			value_type* find(unsigned long long key)
+			{
+				for (size_t i = 0; i < _size; i++)
+				{
+					if (key == _keys[i])
+					{
+						return _values + i;
+					}
+				}
+				return NULL;
+			}
+
+			value_type& insert(unsigned long long key)
+			{
+				value_type* const res = find(key);
+				if (res)
+				{
+					return *res;
+				}
+				if (_size == _capacity)
+				{
+					expand();
+				}
+				_keys[_size] = key;
+				new(_values + _size)value_type();
+				return _values[_size++];
+			}
+
+			bool erase(unsigned long long key)
+			{
+				for (size_t i = 0; i < _size; i++)
+				{
+					if (key == _keys[i])
+					{
+						const size_t last = _size - 1;
+						if (i != last)
+						{
+							_keys[i] = _keys[last];
+							_values[i] = std::move(_values[last]);
+						}
+						_values[last].~value_type();
+						_size = last;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void clear()
+			{
+				for (size_t i = 0; i < _size; i++)
+				{
+					_values[i].~value_type();
+				}
+				_size = 0;
+			}
+
+			size_t size() const
+			{
+				return _size;
+			}
+
+			pck_base* at(size_t i)
+			{
+				assert(i < _size);
+				return _values[i].get();
+			}
+		private:
+			void expand()
+			{
+				const size_t capacity = 2 * _capacity;
+				unsigned long long* const keys = (unsigned long long*)malloc(sizeof(unsigned long long) * capacity);
+				value_type* const values = (value_type*)malloc(sizeof(value_type) * capacity);
+				for (size_t i = 0; i < _size; i++)
+				{
+					keys[i] = _keys[i];
+					new(values + i)value_type(std::move(_values[i]));
+					_values[i].~value_type();
+				}
+				if (_keys != _inlineKeys)
+				{
+					free(_keys);
+					free(_values);
+				}
+				_keys = keys;
+				_values = values;
+				_capacity = capacity;
+			}
+		private:
+			size_t _size;
+			size_t _capacity;
+			unsigned long long* _keys;
+			value_type* _values;
+			unsigned long long _inlineKeys[inline_size];
+			__space_align char _inlineValues[sizeof(value_type) * inline_size];
+			NONE_COPY(msg_type_table);
+		};
+
 		void clear(my_actor* self)
 		{
-			for (auto it = _msgTypeMap.begin(); it != _msgTypeMap.end(); ++it) { it->second->_amutex.quited_lock(self); }
-			for (auto it = _msgTypeMap.begin(); it != _msgTypeMap.end(); ++it) { it->second->close(); }
-			for (auto it = _msgTypeMap.begin(); it != _msgTypeMap.end(); ++it) { it->second->_amutex.quited_unlock(self); }
-			_msgTypeMap.clear();
+			for (size_t i = 0; i < _msgTypeTable.size(); i++) { _msgTypeTable.at(i)->_amutex.quited_lock(self); }
+			for (size_t i = 0; i < _msgTypeTable.size(); i++) { _msgTypeTable.at(i)->close(); }
+			for (size_t i = 0; i < _msgTypeTable.size(); i++) { _msgTypeTable.at(i)->_amutex.quited_unlock(self); }
+			_msgTypeTable.clear();
 		}
 
-		msg_map_shared_alloc<id_key, std::shared_ptr<pck_base> > _msgTypeMap;
-		static msg_map_shared_alloc<id_key, std::shared_ptr<pck_base> >::shared_node_alloc* _msgTypeMapAll;
+		msg_type_table _msgTypeTable;
 	};
 
 	template <typename DST, typename ARG>
@@ -4877,6 +5122,19 @@ public:
 	static actor_handle create(shared_strand actorStrand, main_func mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
 	static actor_handle create(shared_strand actorStrand, AutoStackActorFace_&& wrapActor);
 
+	/*!
+	@brief auto_stackѧϰջߴÿ: key ջߴ p50 p90 p99 
+	*/
+	static void export_auto_stack(std::ostream& out);
+
+	/*!
+	@brief auto_stackջߴ(ջ)install֮
+	@param prewarm ÿĿѧϰĳߴԤٸcontextҪfiberΪ0ʱio_engine߳еã
+	߳еֻߴԤ
+	@return Ŀ
+	*/
+	static size_t import_auto_stack(std::istream& in, size_t prewarm = 0);
+
 	template <typename SharedStrand, typename MainFunc, typename NotifyFunc>
 	static actor_handle create_and_notify(SharedStrand&& actorStrand, MainFunc&& mainFunc, NotifyFunc&& notifyFunc, size_t stackSize = DEFAULT_STACKSIZE)
 	{
@@ -6375,7 +6633,7 @@ private:
 		msg_pool_status::id_key typeID(type_hash<Args...>::hash_code(), id);
 		if (make)
 		{
-			auto& res = host->_msgPoolStatus._msgTypeMap.insert(make_pair(typeID, std::shared_ptr<pck_type>())).first->second;
+			auto& res = host->_msgPoolStatus._msgTypeTable.insert(typeID);
 			if (!res)
 			{
 				res = std::make_shared<pck_type>(host);
@@ -6383,11 +6641,11 @@ private:
 			assert(std::dynamic_pointer_cast<pck_type>(res));
 			return std::static_pointer_cast<pck_type>(res);
 		}
-		auto it = host->_msgPoolStatus._msgTypeMap.find(typeID);
-		if (it != host->_msgPoolStatus._msgTypeMap.end())
+		auto it = host->_msgPoolStatus._msgTypeTable.find(typeID);
+		if (it)
 		{
-			assert(std::dynamic_pointer_cast<pck_type>(it->second));
-			return std::static_pointer_cast<pck_type>(it->second);
+			assert(std::dynamic_pointer_cast<pck_type>(*it));
+			return std::static_pointer_cast<pck_type>(*it);
 		}
 		return std::shared_ptr<pck_type>();
 	}
@@ -6710,19 +6968,19 @@ public:
 		assert(id >= 0 && id < 256);
 		typedef msg_pool_status::pck<Args...> pck_type;
 		msg_pool_status::id_key typeID(type_hash<Args...>::hash_code(), id);
-		auto it = _msgPoolStatus._msgTypeMap.find(typeID);
-		if (_msgPoolStatus._msgTypeMap.end() != it)
+		auto it = _msgPoolStatus._msgTypeTable.find(typeID);
+		if (it)
 		{
 			lock_suspend();
 			lock_quit();
-			assert(std::dynamic_pointer_cast<pck_type>(it->second));
-			std::shared_ptr<pck_type> msgPck = std::static_pointer_cast<pck_type>(it->second);
+			assert(std::dynamic_pointer_cast<pck_type>(*it));
+			std::shared_ptr<pck_type> msgPck = std::static_pointer_cast<pck_type>(*it);
 			msgPck->lock(this);
 			auto msgPool = msgPck->_msgPool;
 			clear_msg_list<Args...>(this, msgPck);
 			msgPck->_msgPool = msgPool;
 			msgPck->clear();
-			_msgPoolStatus._msgTypeMap.erase(it);
+			_msgPoolStatus._msgTypeTable.erase(typeID);//ʱyieldѱ䶯ɾ
 			msgPck->unlock(this);
 			unlock_quit();
 			unlock_suspend();
@@ -7457,6 +7715,60 @@ public:
 
 	__yield_interrupt void pump_msg(const msg_pump_handle<>& pump);
 
+	/*!
+	@brief ϢȡϢȵһϢһȡѻĺϢn
+	@param res ϢԪΪstd::tuple<Args...>ȡϢ׷ӵβ
+	@return ȡϢ
+	*/
+	template <typename... Args, typename Dst>
+	__yield_interrupt size_t pump_msgs(bool checkDis, const msg_pump_handle<Args...>& pump, Dst& res, size_t n)
+	{
+		assert_enter();
+		assert(n);
+		size_t count = pump.get()->try_read_many(res, n);
+		if (!count)
+		{
+			DstReceiverBuff_<Args...> dstRec;
+			_pump_msg(pump, dstRec, checkDis);
+			res.push_back(std::move(dstRec._dstBuff.get()));
+			count = 1 + pump.get()->try_read_many(res, n - 1);
+		}
+		return count;
+	}
+
+	template <typename... Args, typename Dst>
+	__yield_interrupt size_t pump_msgs(const msg_pump_handle<Args...>& pump, Dst& res, size_t n)
+	{
+		return pump_msgs(false, pump, res, n);
+	}
+
+	/*!
+	@brief ԴϢȡϢnûϢ0
+	*/
+	template <typename... Args, typename Dst>
+	__yield_interrupt size_t try_pump_msgs(bool checkDis, const msg_pump_handle<Args...>& pump, Dst& res, size_t n)
+	{
+		assert_enter();
+		assert(n);
+		size_t count = pump.get()->try_read_many(res, n);
+		if (!count)
+		{
+			DstReceiverBuff_<Args...> dstRec;
+			if (_try_pump_msg(pump, dstRec, checkDis))
+			{
+				res.push_back(std::move(dstRec._dstBuff.get()));
+				count = 1 + pump.get()->try_read_many(res, n - 1);
+			}
+		}
+		return count;
+	}
+
+	template <typename... Args, typename Dst>
+	__yield_interrupt size_t try_pump_msgs(const msg_pump_handle<Args...>& pump, Dst& res, size_t n)
+	{
+		return try_pump_msgs(false, pump, res, n);
+	}
+
 	template <typename... Args, typename Handler>
 	__yield_interrupt void pump_msg_invoke(bool checkDis, const msg_pump_handle<Args...>& pump, Handler&& h)
 	{
@@ -76,6 +76,15 @@ void run_thread::set_current_thread_name(const char* name)
 #endif
 }
 
+bool run_thread::set_current_thread_affinity(int cpu)
+{
+	if (cpu < 0 || cpu >= (int)(sizeof(DWORD_PTR) * 8))
+	{//׺λ(64ʱҪ)
+		return false;
+	}
+	return 0 != SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+}
+
 size_t run_thread::cpu_core_number()
 {
 	DWORD size = 0;
@@ -122,6 +131,7 @@ void run_thread::sleep(int ms)
 #include <fstream>
 #include <string>
 #include <sys/prctl.h>
+#include <sched.h>
 
 run_thread::run_thread()
 {
@@ -179,6 +189,18 @@ void run_thread::set_current_thread_name(const char* name)
 	prctl(PR_SET_NAME, name);
 }
 
+bool run_thread::set_current_thread_affinity(int cpu)
+{
+	if (cpu < 0 || cpu >= CPU_SETSIZE)
+	{
+		return false;
+	}
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	return 0 == pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+}
+
 size_t run_thread::cpu_core_number()
 {
 	try
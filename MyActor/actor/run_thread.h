@@ -86,6 +86,10 @@ public:
 	thread_id get_id();
 	void swap(run_thread& s);
 	static void set_current_thread_name(const char* name);
+	/*!
+	@brief 󶨵ǰ̵߳cpuϣIDЧ򳬳ƽ̨ɱʾΧʱfalse
+	*/
+	static bool set_current_thread_affinity(int cpu);
 	static thread_id this_thread_id();
 	static size_t cpu_core_number();
 	static size_t cpu_thread_number();
@@ -24,17 +24,20 @@ struct pc_cycle
 			_sCycle = 0;
 			_msCycle = 0;
 			_usCycle = 0;
+			_nsCycle = 0;
 			assert(false);
 			return;
 		}
 		_sCycle = 1.0 / (double)frep.QuadPart;
 		_msCycle = 1000.0 / (double)frep.QuadPart;
 		_usCycle = 1000000.0 / (double)frep.QuadPart;
+		_nsCycle = 1000000000.0 / (double)frep.QuadPart;
 	}
 
 	double _sCycle;
 	double _msCycle;
 	double _usCycle;
+	double _nsCycle;
 } _pcCycle;
 #endif
 
@@ -307,6 +310,13 @@ void enable_high_resolution()
 	timeBeginPeriod(1);
 }
 
+long long get_tick_ns()
+{
+	LARGE_INTEGER quadPart;
+	QueryPerformanceCounter(&quadPart);
+	return (long long)((double)quadPart.QuadPart*_pcCycle._nsCycle);
+}
+
 long long get_tick_us()
 {
 	LARGE_INTEGER quadPart;
@@ -334,6 +344,13 @@ void enable_high_resolution()
 {
 }
 
+long long get_tick_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
 long long get_tick_us()
 {
 	struct timespec ts;
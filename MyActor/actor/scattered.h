@@ -378,6 +378,7 @@ void print_time_us(std::wostream&);
 void print_time_ms(std::wostream&);
 void print_time_s(std::wostream&);
 
+long long get_tick_ns();
 long long get_tick_us();
 long long get_tick_ms();
 int get_tick_s();
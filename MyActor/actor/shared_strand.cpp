@@ -2,23 +2,37 @@
 #include "actor_timer.h"
 #include "async_timer.h"
 
-#define NEXT_TICK_SPACE_SIZE (sizeof(void*)*8)
+//next_tickߴ
+#ifndef NEXT_TICK_CHUNK_SIZE
+#define NEXT_TICK_CHUNK_SIZE 4096
+#endif
+
+//óߴnext_tick_reuMemAlloc
+#define NEXT_TICK_MAX_SPACE (NEXT_TICK_CHUNK_SIZE / 4)
+
+//Ŀ
+#ifndef NEXT_TICK_FREE_CHUNK
+#define NEXT_TICK_FREE_CHUNK 8
+#endif
+
+#define NEXT_TICK_CHUNK_HEAD MEM_ALIGN(sizeof(tick_chunk), NEXT_TICK_ALIGN)
 
 boost_strand::boost_strand()
 :_ioEngine(NULL), _strand(NULL), _actorTimer(NULL)
 #ifdef ENABLE_NEXT_TICK
 ,_thisRoundCount(0)
+,_backTickCount(0)
+,_tickPtr(NULL)
+,_tickEnd(NULL)
+,_tickChunk(NULL)
+,_freeTickChunk(NULL)
+,_freeTickChunkCount(0)
 ,_reuMemAlloc(NULL)
 #endif //ENABLE_NEXT_TICK
 #if (ENABLE_QT_ACTOR && ENABLE_UV_ACTOR)
 ,_strandChoose(strand_default)
 #endif
 {
-#ifdef ENABLE_NEXT_TICK
-	_nextTickAlloc[0] = NULL;
-	_nextTickAlloc[1] = NULL;
-	_nextTickAlloc[2] = NULL;
-#endif
 }
 
 boost_strand::~boost_strand()
@@ -27,9 +41,14 @@ boost_strand::~boost_strand()
 	assert(_frontTickQueue.empty());
 	assert(_backTickQueue.empty());
 	assert(!_strand || (ready_empty() && waiting_empty()));
-	delete _nextTickAlloc[0];
-	delete _nextTickAlloc[1];
-	delete _nextTickAlloc[2];
+	assert(!_tickChunk || 0 == _tickChunk->_liveCount);
+	free(_tickChunk);
+	while (_freeTickChunk)
+	{
+		tick_chunk* const chunk = _freeTickChunk;
+		_freeTickChunk = chunk->_next;
+		free(chunk);
+	}
 	delete _reuMemAlloc;
 #endif //ENABLE_NEXT_TICK
 	delete _actorTimer;
@@ -47,13 +66,23 @@ shared_strand boost_strand::create(io_engine& ioEngine)
 		res->_strand = new strand_type(ioEngine);
 #ifdef ENABLE_NEXT_TICK
 		res->_reuMemAlloc = new reusable_mem();
-		res->_nextTickAlloc[0] = new mem_alloc2<char[NEXT_TICK_SPACE_SIZE]>(ioEngine._poolSize);
-		res->_nextTickAlloc[1] = new mem_alloc2<char[NEXT_TICK_SPACE_SIZE * 2]>(ioEngine._poolSize / 2);
-		res->_nextTickAlloc[2] = new mem_alloc2<char[NEXT_TICK_SPACE_SIZE * 4]>(ioEngine._poolSize / 4);
 #endif
 		res->_actorTimer = new ActorTimer_(res);
 		res->_overTimer = new overlap_timer(res);
 	}
+	res->_strand->_preferHome = false;
+#ifdef ENABLE_SCHEDULER_STATS
+	res->_stats.clear();
+	res->_strand->_stats = &res->_stats;
+#endif
+	return res;
+}
+
+shared_strand boost_strand::create(io_engine& ioEngine, size_t preferWorker)
+{
+	shared_strand res = create(ioEngine);
+	res->_strand->_homeWorker = preferWorker;
+	res->_strand->_preferHome = true;
 	return res;
 }
 
@@ -178,6 +207,25 @@ overlap_timer* boost_strand::over_timer()
 	return _overTimer;
 }
 
+#ifdef ENABLE_SCHEDULER_STATS
+boost_strand::stats_info boost_strand::stats()
+{
+	stats_info res;
+	res.posted = _stats._postCount.load(std::memory_order_relaxed);
+	res.dispatched = _stats._dispatchCount.load(std::memory_order_relaxed);
+	res.ticked = _stats._tickCount.load(std::memory_order_relaxed);
+	res.invoked = _stats._invokeCount.load(std::memory_order_relaxed);
+	res.peakDepth = _stats._peakDepth.load(std::memory_order_relaxed);
+	res.runTime = _stats._runTime.load(std::memory_order_relaxed) / 1000;
+	return res;
+}
+
+void boost_strand::reset_stats()
+{
+	_stats.clear();
+}
+#endif
+
 std::shared_ptr<AsyncTimer_> boost_strand::make_timer()
 {
 	std::shared_ptr<AsyncTimer_> res = std::make_shared<AsyncTimer_>(_actorTimer);
@@ -198,11 +246,6 @@ bool boost_strand::waiting_empty()
 	return _strand->waiting_empty();
 }
 
-void boost_strand::push_next_tick(wrap_next_tick_face* handler)
-{
-	_backTickQueue.push_back(handler);
-}
-
 void boost_strand::run_tick_front()
 {
 	if (_thisRoundCount)
@@ -212,14 +255,9 @@ void boost_strand::run_tick_front()
 	while (!_frontTickQueue.empty())
 	{
 		wrap_next_tick_face* const tick = static_cast<wrap_next_tick_face*>(_frontTickQueue.pop_front());
-		const size_t spaceSize = tick->invoke();
-		switch (MEM_ALIGN(spaceSize, NEXT_TICK_SPACE_SIZE) / NEXT_TICK_SPACE_SIZE)
-		{
-		case 1: _nextTickAlloc[0]->deallocate(tick); break;
-		case 2: _nextTickAlloc[1]->deallocate(tick); break;
-		case 3: case 4: _nextTickAlloc[2]->deallocate(tick); break;
-		default: _reuMemAlloc->deallocate(tick); break;
-		}
+		tick_chunk* const chunk = tick->_chunk;
+		tick->_invoke(tick);
+		free_tick(tick, chunk);
 	}
 }
 
@@ -230,23 +268,21 @@ void boost_strand::run_tick_back()
 	{
 		return;
 	}
-	size_t tickCount = _thisRoundCount;
+	//һִ걾֮ǰͶݵtickִͶݵһ
+	size_t tickCount = _backTickCount;
 	_thisRoundCount = 0;
-	while (!_backTickQueue.empty() && tickCount--)
+	while (tickCount-- && !_backTickQueue.empty())
 	{
 		wrap_next_tick_face* const tick = static_cast<wrap_next_tick_face*>(_backTickQueue.pop_front());
-		const size_t spaceSize = tick->invoke();
-		switch (MEM_ALIGN(spaceSize, NEXT_TICK_SPACE_SIZE) / NEXT_TICK_SPACE_SIZE)
-		{
-		case 1: _nextTickAlloc[0]->deallocate(tick); break;
-		case 2: _nextTickAlloc[1]->deallocate(tick); break;
-		case 3: case 4: _nextTickAlloc[2]->deallocate(tick); break;
-		default: _reuMemAlloc->deallocate(tick); break;
-		}
+		_backTickCount--;
+		tick_chunk* const chunk = tick->_chunk;
+		tick->_invoke(tick);
+		free_tick(tick, chunk);
 	}
 	if (!_backTickQueue.empty())
 	{
 		_backTickQueue.swap(_frontTickQueue);
+		_backTickCount = 0;
 		if (waiting_empty())
 		{
 			post(any_handler());
@@ -254,15 +290,64 @@ void boost_strand::run_tick_back()
 	}
 }
 
-void* boost_strand::alloc_space(size_t size)
+void* boost_strand::alloc_tick_slow(size_t size, tick_chunk*& chunk)
 {
-	switch (MEM_ALIGN(size, NEXT_TICK_SPACE_SIZE) / NEXT_TICK_SPACE_SIZE)
+	if (size > NEXT_TICK_MAX_SPACE)
+	{
+		chunk = NULL;
+		return _reuMemAlloc->allocate(size);
+	}
+	//ǰһ飬tickȫִ
+	tick_chunk* newChunk = _freeTickChunk;
+	if (newChunk)
+	{
+		_freeTickChunk = newChunk->_next;
+		_freeTickChunkCount--;
+	}
+	else
+	{
+		newChunk = (tick_chunk*)malloc(NEXT_TICK_CHUNK_SIZE);
+	}
+	newChunk->_next = NULL;
+	newChunk->_liveCount = 0;
+	_tickChunk = newChunk;
+	_tickPtr = (char*)newChunk + NEXT_TICK_CHUNK_HEAD;
+	_tickEnd = (char*)newChunk + NEXT_TICK_CHUNK_SIZE;
+	return alloc_tick(size, chunk);
+}
+
+void boost_strand::free_tick(wrap_next_tick_face* tick, tick_chunk* chunk)
+{
+	if (!chunk)
+	{
+		_reuMemAlloc->deallocate(tick);
+	}
+	else if (0 == --chunk->_liveCount)
+	{
+		if (chunk == _tickChunk)
+		{
+			//tickȫִ꣬
+			_tickPtr = (char*)chunk + NEXT_TICK_CHUNK_HEAD;
+		}
+		else
+		{
+			free_chunk(chunk);
+		}
+	}
+}
+
+void boost_strand::free_chunk(tick_chunk* chunk)
+{
+	if (_freeTickChunkCount < NEXT_TICK_FREE_CHUNK)
+	{
+		chunk->_next = _freeTickChunk;
+		_freeTickChunk = chunk;
+		_freeTickChunkCount++;
+	}
+	else
 	{
-	case 1: return !_nextTickAlloc[0]->overflow() ? _nextTickAlloc[0]->allocate() : NULL;
-	case 2: return !_nextTickAlloc[1]->overflow() ? _nextTickAlloc[1]->allocate() : NULL;
-	case 3: case 4: return !_nextTickAlloc[2]->overflow() ? _nextTickAlloc[2]->allocate() : NULL;
+		free(chunk);
 	}
-	return NULL;
 }
 
 #endif //ENABLE_NEXT_TICK
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "wrapped_next_tick_handler.h"
 #include "wrapped_distribute_handler.h"
 #include "strand_ex.h"
+#include "event_trace.h"
 #include "io_engine.h"
 #include "msg_queue.h"
 #include "scattered.h"
@@ -56,12 +57,14 @@ else\
 
 #ifdef ENABLE_NEXT_TICK
 
+//next_tick
+#define NEXT_TICK_ALIGN (sizeof(void*)*2)
+
 #define APPEND_TICK()\
-	typedef wrap_next_tick_handler<RM_CREF(Handler), true> wrap_tick_type1; \
-	typedef wrap_next_tick_handler<RM_CREF(Handler), false> wrap_tick_type2; \
-	void* const space = alloc_space(sizeof(wrap_tick_type1)); \
-	push_next_tick(space ? static_cast<wrap_next_tick_face*>(new(space)wrap_tick_type1(std::forward<Handler>(handler))) : \
-	static_cast<wrap_next_tick_face*>(new(_reuMemAlloc->allocate(sizeof(wrap_tick_type2)))wrap_tick_type2(std::forward<Handler>(handler))));
+	typedef wrap_next_tick_handler<RM_CREF(Handler)> wrap_tick_type; \
+	tick_chunk* chunk; \
+	void* const space = alloc_tick(sizeof(wrap_tick_type), chunk); \
+	push_next_tick(new(space)wrap_tick_type(std::forward<Handler>(handler), chunk));
 
 #else //ENABLE_NEXT_TICK
 
@@ -80,6 +83,12 @@ else\
 	post_choose(std::forward<Handler>(handler)); \
 }
 
+#ifdef ENABLE_SCHEDULER_STATS
+#define STRAND_STATS_INC(__counter__) _stats.inc(_stats.__counter__)
+#else
+#define STRAND_STATS_INC(__counter__)
+#endif
+
 #ifdef DISABLE_BOOST_TIMER
 struct TimerBoostCompletedEventFace_
 {
@@ -115,41 +124,37 @@ class boost_strand
 		void operator =(const handler_capture&) = delete;
 	};
 
-	struct wrap_next_tick_face : public op_queue::face
+	/*!
+	@brief next_tickڴ飬˳з֣tickȫִ
+	*/
+	struct tick_chunk
 	{
-		virtual size_t invoke() = 0;
+		tick_chunk* _next;
+		size_t _liveCount;
 	};
 
-	template <typename Handler, bool NtSpace>
-	struct wrap_next_tick_handler : public wrap_next_tick_face
+	struct wrap_next_tick_face : public op_queue::face
 	{
-		template <typename H>
-		wrap_next_tick_handler(H&& handler)
-			:_handler(std::forward<H>(handler)) {}
-
-		size_t invoke()
-		{
-			CHECK_EXCEPTION(_handler);
-			this->~wrap_next_tick_handler();
-			return sizeof(wrap_next_tick_handler);
-		}
-
-		Handler _handler;
-		NONE_COPY(wrap_next_tick_handler);
+		void (*_invoke)(wrap_next_tick_face*);
+		tick_chunk* _chunk;
 	};
 
 	template <typename Handler>
-	struct wrap_next_tick_handler<Handler, false> : public wrap_next_tick_face
+	struct wrap_next_tick_handler : public wrap_next_tick_face
 	{
 		template <typename H>
-		wrap_next_tick_handler(H&& handler)
-			:_handler(std::forward<H>(handler)) {}
+		wrap_next_tick_handler(H&& handler, tick_chunk* chunk)
+			:_handler(std::forward<H>(handler))
+		{
+			this->_invoke = &wrap_next_tick_handler::invoke;
+			this->_chunk = chunk;
+		}
 
-		size_t invoke()
+		static void invoke(wrap_next_tick_face* face)
 		{
-			CHECK_EXCEPTION(_handler);
-			this->~wrap_next_tick_handler();
-			return (size_t)-1 >> 1;
+			wrap_next_tick_handler* const self = static_cast<wrap_next_tick_handler*>(face);
+			CHECK_EXCEPTION(self->_handler);
+			self->~wrap_next_tick_handler();
 		}
 
 		Handler _handler;
@@ -232,6 +237,12 @@ protected:
 #endif
 public:
 	static shared_strand create(io_engine& ioEngine);
+
+	/*!
+	@brief strandwork_stealingģʽڵpreferWorker߳У
+	actorʹͬһpreferWorkerɹĻ(shared_queueģʽº)
+	*/
+	static shared_strand create(io_engine& ioEngine, size_t preferWorker);
 	static std::vector<shared_strand> create_multi(size_t n, io_engine& ioEngine);
 	static void create_multi(shared_strand* res, size_t n, io_engine& ioEngine);
 	static void create_multi(std::vector<shared_strand>& res, size_t n, io_engine& ioEngine);
@@ -260,6 +271,8 @@ public:
 	template <typename Handler>
 	void dispatch(Handler&&  handler)
 	{
+		STRAND_STATS_INC(_dispatchCount);
+		EVENT_TRACE(et_strand_dispatch, this);
 #if (ENABLE_QT_ACTOR || ENABLE_UV_ACTOR)
 		CHOOSE_DISPATCH();
 #else
@@ -273,6 +286,8 @@ public:
 	template <typename Handler>
 	void post(Handler&& handler)
 	{
+		STRAND_STATS_INC(_postCount);
+		EVENT_TRACE(et_strand_post, this);
 #if (ENABLE_QT_ACTOR || ENABLE_UV_ACTOR)
 		CHOOSE_POST();
 #else
@@ -288,6 +303,8 @@ public:
 	{
 		assert(running_in_this_thread());
 		assert(is_running());//, strandûʼһpostѾͶtick
+		STRAND_STATS_INC(_tickCount);
+		EVENT_TRACE(et_strand_tick, this);
 #if (ENABLE_QT_ACTOR || ENABLE_UV_ACTOR)
 		CHOOSE_TICK();
 #else
@@ -478,6 +495,30 @@ public:
 	@brief ȡصʱ
 	*/
 	overlap_timer* over_timer();
+#ifdef ENABLE_SCHEDULER_STATS
+	/*!
+	@brief strandͳƿ
+	*/
+	struct stats_info
+	{
+		unsigned long long posted;//postͶ
+		unsigned long long dispatched;//dispatchͶ
+		unsigned long long ticked;//next_tickͶ
+		unsigned long long invoked;//Ӷȡִе
+		unsigned long long peakDepth;//ִе(зֵ)
+		long long runTime;//ۼִʱ(us)
+	};
+
+	/*!
+	@brief ȡͳƣ߳еãҪֹͣ
+	*/
+	stats_info stats();
+
+	/*!
+	@brief ͳ
+	*/
+	void reset_stats();
+#endif
 private:
 	/*!
 	@brief ȡActorʱ
@@ -536,17 +577,44 @@ private:
 #endif
 	}
 #endif
-	void* alloc_space(size_t size);
 protected:
 #ifdef ENABLE_NEXT_TICK
 	bool ready_empty();
 	bool waiting_empty();
-	void push_next_tick(wrap_next_tick_face* handler);
 	void run_tick_front();
 	void run_tick_back();
+
+	void push_next_tick(wrap_next_tick_face* handler)
+	{
+		_backTickQueue.push_back(handler);
+		_backTickCount++;
+	}
+
+	void* alloc_tick(size_t size, tick_chunk*& chunk)
+	{
+		size = MEM_ALIGN(size, NEXT_TICK_ALIGN);
+		if (size <= (size_t)(_tickEnd - _tickPtr))
+		{
+			void* const space = _tickPtr;
+			_tickPtr += size;
+			_tickChunk->_liveCount++;
+			chunk = _tickChunk;
+			return space;
+		}
+		return alloc_tick_slow(size, chunk);
+	}
+
+	void* alloc_tick_slow(size_t size, tick_chunk*& chunk);
+	void free_tick(wrap_next_tick_face* tick, tick_chunk* chunk);
+	void free_chunk(tick_chunk* chunk);
 	size_t _thisRoundCount;
+	size_t _backTickCount;
+	char* _tickPtr;
+	char* _tickEnd;
+	tick_chunk* _tickChunk;
+	tick_chunk* _freeTickChunk;
+	size_t _freeTickChunkCount;
 	reusable_mem* _reuMemAlloc;
-	mem_alloc_base* _nextTickAlloc[3];
 	op_queue _backTickQueue;
 	op_queue _frontTickQueue;
 #endif //ENABLE_NEXT_TICK
@@ -560,6 +628,9 @@ protected:
 	io_engine* _ioEngine;
 	strand_type* _strand;
 	std::weak_ptr<boost_strand> _weakThis;
+#ifdef ENABLE_SCHEDULER_STATS
+	StrandStats_ _stats;
+#endif
 	NONE_COPY(boost_strand);
 public:
 	/*!
@@ -637,5 +708,6 @@ public:
 #undef CHOOSE_POST_FRONT
 #undef CHOOSE_DISPATCH_FRONT
 #undef APPEND_TICK
+#undef STRAND_STATS_INC
 
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "strand_ex.h"
 #include "io_engine.h"
 
+#ifdef ENABLE_ASIO_STRAND
 struct get_impl_ready_empty_strand_ex
 {
 	bool _empty;
@@ -55,20 +56,66 @@ namespace boost
 		}
 	}
 }
+#endif
 //////////////////////////////////////////////////////////////////////////
 
+#ifdef ENABLE_SCHEDULER_STATS
+StrandStats_::StrandStats_()
+:_postCount(0), _dispatchCount(0), _tickCount(0), _invokeCount(0), _peakDepth(0), _runTime(0) {}
+
+void StrandStats_::clear()
+{
+	_postCount.store(0, std::memory_order_relaxed);
+	_dispatchCount.store(0, std::memory_order_relaxed);
+	_tickCount.store(0, std::memory_order_relaxed);
+	_invokeCount.store(0, std::memory_order_relaxed);
+	_peakDepth.store(0, std::memory_order_relaxed);
+	_runTime.store(0, std::memory_order_relaxed);
+}
+
+void StrandStats_::inc(std::atomic<unsigned long long>& counter)
+{
+	counter.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+void StrandEx_::run_handler::operator()() const
+{
+	if (_strand->run_tasks())
+	{//еȴеͶݣó̸߳strand
+		_strand->_ioEngine._ios.post(*this);
+	}
+}
+
 StrandEx_::StrandEx_(io_engine& ios)
-: _service(boost::asio::use_service<boost::asio::detail::strand_service>(ios)),
-_impl(new boost::asio::detail::strand_service::strand_impl()) {}
+:
+#ifdef ENABLE_ASIO_STRAND
+_service(boost::asio::use_service<boost::asio::detail::strand_service>(ios)),
+_impl(new boost::asio::detail::strand_service::strand_impl()),
+#endif
+_ioEngine(ios), _homeWorker(ios._stealHome++), _preferHome(false), _workSteal(io_engine::work_stealing == ios._scheduleMode)
+#ifdef ENABLE_SCHEDULER_STATS
+,_stats(NULL)
+#endif
+{}
 
 StrandEx_::~StrandEx_()
 {
+	assert(!_waitQueue.locked());
+#ifdef ENABLE_ASIO_STRAND
 	delete _impl;
+#endif
 }
 
 bool StrandEx_::running_in_this_thread() const
 {
-	return boost::asio::detail::call_stack<boost::asio::detail::strand_service::strand_impl>::contains(_impl) != 0;
+#ifdef ENABLE_ASIO_STRAND
+	if (!_workSteal)
+	{
+		return boost::asio::detail::call_stack<boost::asio::detail::strand_service::strand_impl>::contains(_impl) != 0;
+	}
+#endif
+	return boost::asio::detail::call_stack<StrandEx_, size_t>::contains((StrandEx_*)this) != 0;
 }
 
 bool StrandEx_::empty() const
@@ -78,40 +125,177 @@ bool StrandEx_::empty() const
 
 bool StrandEx_::ready_empty() const
 {
-	get_impl_ready_empty_strand_ex t;
-	_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
-	return t._empty;
+#ifdef ENABLE_ASIO_STRAND
+	if (!_workSteal)
+	{
+		get_impl_ready_empty_strand_ex t;
+		_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
+		return t._empty;
+	}
+#endif
+	return ((op_queue&)_readyQueue).empty();
 }
 
 bool StrandEx_::waiting_empty() const
 {
-	get_impl_waiting_empty_strand_ex t;
-	_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
-	return t._empty;
+#ifdef ENABLE_ASIO_STRAND
+	if (!_workSteal)
+	{
+		get_impl_waiting_empty_strand_ex t;
+		_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
+		return t._empty;
+	}
+#endif
+	return _waitQueue.waiting_empty();
 }
 
 bool StrandEx_::running() const
 {
 	assert(running_in_this_thread());
-	get_impl_running_strand_ex t;
-	_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
-	return t._running;
+#ifdef ENABLE_ASIO_STRAND
+	if (!_workSteal)
+	{
+		get_impl_running_strand_ex t;
+		_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
+		return t._running;
+	}
+#endif
+	return _waitQueue.locked();
 }
 
 bool StrandEx_::safe_running() const
 {
 	assert(!running_in_this_thread());
-	get_impl_safe_running_strand_ex t;
-	_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
-	return t._running;
+#ifdef ENABLE_ASIO_STRAND
+	if (!_workSteal)
+	{
+		get_impl_safe_running_strand_ex t;
+		_service.post((boost::asio::detail::strand_service::implementation_type&)_impl, t);
+		return t._running;
+	}
+#endif
+	return _waitQueue.locked();
 }
 
 bool StrandEx_::only_self() const
 {
 	assert(running_in_this_thread());
+#ifdef ENABLE_ASIO_STRAND
+	if (!_workSteal)
+	{
 #ifdef ASIO_CALL_STACK_DEPTH
-	return 1 == boost::asio::detail::call_stack<boost::asio::detail::strand_service::strand_impl>::stack_depth();
+		return 1 == boost::asio::detail::call_stack<boost::asio::detail::strand_service::strand_impl>::stack_depth();
 #else
+		return true;
+#endif
+	}
+#endif
+	return 1 == *boost::asio::detail::call_stack<StrandEx_, size_t>::top();
+}
+
+size_t StrandEx_::push_depth()
+{
+	size_t* const top = boost::asio::detail::call_stack<StrandEx_, size_t>::top();
+	return top ? *top + 1 : 1;
+}
+
+void StrandEx_::append_task(wrap_handler_face* h)
+{
+	if (_waitQueue.push(h))
+	{//strandУռȨִ
+		_readyQueue.push_back(h);
+		schedule();
+	}
+}
+
+void StrandEx_::schedule()
+{
+	if (_workSteal)
+	{
+		_lockIos.create(_ioEngine._ios);
+		_ioEngine.stealSchedule(this);
+	}
+	else
+	{
+		run_handler runHandler = { this };
+		_ioEngine._ios.post(runHandler);
+	}
+}
+
+bool StrandEx_::dispatch_lock()
+{
+	return _ioEngine.runningInThisIos() && _waitQueue.try_lock();
+}
+
+void StrandEx_::dispatch_unlock()
+{
+	assert(_readyQueue.empty());
+	if (!_waitQueue.try_unlock())
+	{
+		_waitQueue.pop_all(_readyQueue);
+		schedule();
+	}
+}
+
+bool StrandEx_::run_tasks()
+{
+	assert(_waitQueue.locked());
+	{
+#ifdef ENABLE_SCHEDULER_STATS
+		const long long beginTime = get_tick_ns();
+		unsigned long long n = 0;
+#endif
+		size_t depth = push_depth();
+		boost::asio::detail::call_stack<StrandEx_, size_t>::context ctx(this, depth);
+		while (!_readyQueue.empty())
+		{
+			static_cast<wrap_handler_face*>(_readyQueue.pop_front())->invoke();
+#ifdef ENABLE_SCHEDULER_STATS
+			n++;
+#endif
+		}
+#ifdef ENABLE_SCHEDULER_STATS
+		stats_run(n, beginTime);
+#endif
+	}
+	if (_waitQueue.pop_all(_readyQueue))
+	{//еȴе񣬱ռòŶ
+		return true;
+	}
+	if (_workSteal)
+	{//ͷռú߳̿ռãͷios
+		_lockIos.destroy();
+	}
+	if (_waitQueue.try_unlock())
+	{
+		return false;
+	}
+	_waitQueue.pop_all(_readyQueue);
+	if (_workSteal)
+	{
+		_lockIos.create(_ioEngine._ios);
+	}
 	return true;
+}
+
+#ifdef ENABLE_SCHEDULER_STATS
+void StrandEx_::stats_run(unsigned long long n, long long beginTime)
+{
+	const long long runTime = get_tick_ns() - beginTime;
+	if (_stats)
+	{
+		_stats->_invokeCount.fetch_add(n, std::memory_order_relaxed);
+		_stats->_runTime.fetch_add(runTime, std::memory_order_relaxed);
+		if (n > _stats->_peakDepth.load(std::memory_order_relaxed))
+		{//ֻռstrand̻߳д룬ҪCAS
+			_stats->_peakDepth.store(n, std::memory_order_relaxed);
+		}
+	}
+	io_engine::stats_slot* const slot = (io_engine::stats_slot*)io_engine::getTlsValue(SCHEDULER_STATS_TLS_INDEX);
+	if (slot)
+	{
+		slot->_taskCount.fetch_add(n, std::memory_order_relaxed);
+		slot->_busyTime.fetch_add(runTime, std::memory_order_relaxed);
+	}
+}
 #endif
-}
\ No newline at end of file
@@ -2,18 +2,85 @@
 #define __STRAND_EX_H
 
 #include <algorithm>
+#include <atomic>
+#include <boost/asio/io_service.hpp>
+#ifdef ENABLE_ASIO_STRAND
 #include <boost/asio/detail/strand_service.hpp>
+#endif
+#include <boost/asio/detail/call_stack.hpp>
+#include <boost/asio/detail/handler_alloc_helpers.hpp>
 #include "try_move.h"
+#include "msg_queue.h"
+#include "stack_object.h"
 
 class io_engine;
 class boost_strand;
 
+//ʹasio strand_serviceʵshared_queueģʽµstrand߳Ͷ
+//#define ENABLE_ASIO_STRAND
+
+//strand/io_engineͳƣʹrelaxedԭӲʱκο
+//#define ENABLE_SCHEDULER_STATS
+
+#ifdef ENABLE_SCHEDULER_STATS
+/*!
+@brief strandͳƼмֻ֤һ
+*/
+struct StrandStats_
+{
+	StrandStats_();
+	void clear();
+	void inc(std::atomic<unsigned long long>& counter);
+
+	std::atomic<unsigned long long> _postCount;
+	std::atomic<unsigned long long> _dispatchCount;
+	std::atomic<unsigned long long> _tickCount;
+	std::atomic<unsigned long long> _invokeCount;
+	std::atomic<unsigned long long> _peakDepth;
+	std::atomic<long long> _runTime;
+};
+#endif
+
 /*!
-@brief ޸ı׼boost strandimpl_Ϊռ
+@brief ޸ı׼boost strandimpl_Ϊռ
+ĬʹMPSCڶУռ߳ȡִУ
+io_engineΪwork_stealingģʽʱɱضеȣͶݵios
 */
-class StrandEx_
+class StrandEx_ : public op_queue::face
 {
 	friend boost_strand;
+	friend io_engine;
+
+	struct wrap_handler_face : public op_queue::face
+	{
+		virtual void invoke() = 0;
+	};
+
+	template <typename Handler>
+	struct wrap_handler : public wrap_handler_face
+	{
+		template <typename H>
+		wrap_handler(H&& h)
+			:_handler(std::forward<H>(h)) {}
+
+		void invoke()
+		{
+			Handler handler(std::move(_handler));
+			this->~wrap_handler();
+			boost_asio_handler_alloc_helpers::deallocate(this, sizeof(wrap_handler), handler);
+			CHECK_EXCEPTION(handler);
+		}
+
+		Handler _handler;
+		NONE_COPY(wrap_handler);
+	};
+
+	struct run_handler
+	{
+		void operator()() const;
+
+		StrandEx_* _strand;
+	};
 private:
 	StrandEx_(io_engine& ios);
 	~StrandEx_();
@@ -29,19 +96,85 @@ private:
 	template <typename Handler>
 	void post(Handler&& handler)
 	{
-		//_service.post(_impl, std::forward<Handler>(handler));
-		_service.post(_impl, handler);
+#ifdef ENABLE_ASIO_STRAND
+		if (!_workSteal)
+		{
+			//_service.post(_impl, std::forward<Handler>(handler));
+			_service.post(_impl, handler);
+			return;
+		}
+#endif
+		append_task(make_wrap_handler(std::forward<Handler>(handler)));
 	}
 
 	template <typename Handler>
 	void dispatch(Handler&& handler)
 	{
-		//_service.dispatch(_impl, std::forward<Handler>(handler));
-		_service.dispatch(_impl, handler);
+#ifdef ENABLE_ASIO_STRAND
+		if (!_workSteal)
+		{
+			//_service.dispatch(_impl, std::forward<Handler>(handler));
+			_service.dispatch(_impl, handler);
+			return;
+		}
+#endif
+		if (running_in_this_thread())
+		{
+			CHECK_EXCEPTION(handler);
+		}
+		else if (dispatch_lock())
+		{
+			{
+#ifdef ENABLE_SCHEDULER_STATS
+				const long long beginTime = get_tick_ns();
+#endif
+				size_t depth = push_depth();
+				boost::asio::detail::call_stack<StrandEx_, size_t>::context ctx(this, depth);
+				CHECK_EXCEPTION(handler);
+#ifdef ENABLE_SCHEDULER_STATS
+				stats_run(1, beginTime);
+#endif
+			}
+			dispatch_unlock();
+		}
+		else
+		{
+			append_task(make_wrap_handler(std::forward<Handler>(handler)));
+		}
 	}
 private:
+	template <typename Handler>
+	static wrap_handler_face* make_wrap_handler(Handler&& handler)
+	{
+		typedef wrap_handler<RM_CREF(Handler)> handler_type;
+		void* const space = boost_asio_handler_alloc_helpers::allocate(sizeof(handler_type), handler);
+		return new(space)handler_type(std::forward<Handler>(handler));
+	}
+
+	static size_t push_depth();
+	void append_task(wrap_handler_face* h);
+	void schedule();
+	bool dispatch_lock();
+	void dispatch_unlock();
+	bool run_tasks();
+#ifdef ENABLE_SCHEDULER_STATS
+	void stats_run(unsigned long long n, long long beginTime);
+#endif
+private:
+#ifdef ENABLE_ASIO_STRAND
 	boost::asio::detail::strand_service& _service;
 	boost::asio::detail::strand_service::implementation_type _impl;
+#endif
+	io_engine& _ioEngine;
+	mpsc_op_queue _waitQueue;
+	op_queue _readyQueue;
+	stack_obj<boost::asio::io_service::work, false> _lockIos;
+	size_t _homeWorker;
+	bool _preferHome;//_homeWorkerΪָ̣߳ȡִкԻص߳
+	bool _workSteal;
+#ifdef ENABLE_SCHEDULER_STATS
+	StrandStats_* _stats;
+#endif
 };
 
-#endif
\ No newline at end of file
+#endif
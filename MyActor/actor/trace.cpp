@@ -0,0 +1,471 @@
+#include "trace.h"
+#include "io_engine.h"
+#include "scattered.h"
+#include "check_actor_stack.h"
+#include <fstream>
+#include <thread>
+#include <condition_variable>
+#include <algorithm>
+
+#ifndef TRACE_ANDROID_LOG
+
+#define TRACE_RECORD_ALIGN 16
+#define TRACE_RECORD_WRAP ((unsigned)-1)
+
+/*!
+@brief ߵ߼¼head/tailΪֽڼ
+*/
+struct TraceRing_
+{
+	struct record_head
+	{
+		unsigned long long _seq;
+		unsigned _length;//wchar_tTRACE_RECORD_WRAPʾ
+		unsigned _pad;
+	};
+
+	TraceRing_(size_t size)
+		:_size(size), _buff((char*)malloc(size)), _head(0), _tail(0), _busy(false), _retired(false), _streamBusy(false) {}
+
+	~TraceRing_()
+	{
+		free(_buff);
+	}
+
+	/*!
+	@brief дһ¼ռ䲻㷵false
+	*/
+	bool push(unsigned long long seq, const std::wstring& s, bool endLine)
+	{
+		const size_t length = s.size() + (endLine ? 1 : 0);
+		const size_t need = record_size(length);
+		assert(need <= max_record());
+		const size_t head = _head.load(std::memory_order_relaxed);
+		const size_t offset = head & (_size - 1);
+		const size_t contiguous = _size - offset;
+		const size_t total = need > contiguous ? contiguous + need : need;
+		if (total > _size - (head - _tail.load(std::memory_order_acquire)))
+		{
+			return false;
+		}
+		char* p = _buff + offset;
+		if (need > contiguous)
+		{
+			((record_head*)p)->_length = TRACE_RECORD_WRAP;
+			p = _buff;
+		}
+		record_head* rh = (record_head*)p;
+		rh->_seq = seq;
+		rh->_length = (unsigned)length;
+		wchar_t* const data = (wchar_t*)(rh + 1);
+		memcpy(data, s.data(), s.size() * sizeof(wchar_t));
+		if (endLine)
+		{
+			data[s.size()] = L'\n';
+		}
+		_head.store(head + total, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+	@brief ¼(¼ͷ)ֽļ¼ֱͬд
+	һʱҲcontiguous + need < _sizepushڻճɹ
+	*/
+	size_t max_record() const
+	{
+		return _size / 2;
+	}
+
+	bool fits(const std::wstring& s, bool endLine) const
+	{
+		return record_size(s.size() + (endLine ? 1 : 0)) <= max_record();
+	}
+
+	static size_t record_size(size_t length)
+	{
+		return sizeof(record_head) + MEM_ALIGN(length * sizeof(wchar_t), TRACE_RECORD_ALIGN);
+	}
+
+	const size_t _size;
+	char* const _buff;
+	std::atomic<size_t> _head;
+	std::atomic<size_t> _tail;
+	std::atomic<bool> _busy;
+	bool _retired;
+	bool _streamBusy;
+	_Tracestream _stream;
+};
+
+/*!
+@brief ̨д̼߳м¼
+*/
+struct TraceWriter_
+{
+	struct item
+	{
+		unsigned long long _seq;
+		const wchar_t* _data;
+		unsigned _length;
+
+		bool operator <(const item& s) const
+		{
+			return _seq < s._seq;
+		}
+	};
+
+	TraceWriter_(const char* path, int flushMs, size_t ringSize)
+		:_out(NULL), _flushMs(flushMs), _stop(false), _passes(0), _seq(0), _sharedRing(ringSize)
+	{
+		if (path)
+		{
+			_file.open(path, std::ios::out | std::ios::app);
+			if (_file.is_open())
+			{
+				_out = &_file;
+			}
+		}
+		else
+		{
+			_out = &std::wcout;
+		}
+	}
+
+	void run()
+	{
+		std::vector<TraceRing_*> rings;
+		std::vector<size_t> heads;
+		std::vector<item> items;
+		std::wstring batch;
+		while (true)
+		{
+			bool stop = false;
+			{
+				std::unique_lock<std::mutex> ul(_mutex);
+				if (!_stop)
+				{
+					_conVar.wait_for(ul, std::chrono::milliseconds(_flushMs));
+				}
+				stop = _stop;
+			}
+			{
+				std::lock_guard<std::mutex> lg(_ringsMutex);
+				rings.assign(_rings.begin(), _rings.end());
+			}
+			rings.push_back(&_sharedRing);
+			heads.resize(rings.size());
+			items.clear();
+			for (size_t i = 0; i < rings.size(); i++)
+			{
+				TraceRing_* const ring = rings[i];
+				const size_t head = ring->_head.load(std::memory_order_acquire);
+				size_t tail = ring->_tail.load(std::memory_order_relaxed);
+				heads[i] = head;
+				while (tail != head)
+				{
+					const size_t offset = tail & (ring->_size - 1);
+					TraceRing_::record_head* rh = (TraceRing_::record_head*)(ring->_buff + offset);
+					if (TRACE_RECORD_WRAP == rh->_length)
+					{
+						tail += ring->_size - offset;
+						continue;
+					}
+					item it = { rh->_seq, (const wchar_t*)(rh + 1), rh->_length };
+					items.push_back(it);
+					tail += TraceRing_::record_size(rh->_length);
+				}
+			}
+			if (!items.empty())
+			{
+				//̼߳¼ȫźϲ
+				std::sort(items.begin(), items.end());
+				batch.clear();
+				for (const item& it : items)
+				{
+					batch.append(it._data, it._length);
+				}
+				if (_out)
+				{
+					TraceMutex_ mt;
+					*_out << batch << std::flush;
+				}
+			}
+			for (size_t i = 0; i < rings.size(); i++)
+			{
+				rings[i]->_tail.store(heads[i], std::memory_order_release);
+			}
+			clear_retired();
+			{
+				std::lock_guard<std::mutex> lg(_mutex);
+				_passes++;
+			}
+			_passConVar.notify_all();
+			if (stop && items.empty())
+			{
+				break;
+			}
+		}
+	}
+
+	/*!
+	@brief ɾ߳˳дļ¼
+	*/
+	static void clear_retired()
+	{
+		std::lock_guard<std::mutex> lg(_ringsMutex);
+		for (size_t i = 0; i < _rings.size();)
+		{
+			TraceRing_* const ring = _rings[i];
+			if (ring->_retired && ring->_head.load(std::memory_order_acquire) == ring->_tail.load(std::memory_order_relaxed))
+			{
+				_rings[i] = _rings.back();
+				_rings.pop_back();
+				delete ring;
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	void notify()
+	{
+		_conVar.notify_one();
+	}
+
+	std::wostream* _out;
+	std::wofstream _file;
+	const int _flushMs;
+	bool _stop;
+	unsigned long long _passes;//ɵдִ
+	std::atomic<unsigned long long> _seq;
+	std::mutex _mutex;
+	std::condition_variable _conVar;
+	std::condition_variable _passConVar;
+	TraceRing_ _sharedRing;//io_engine̹߳ã_sharedMutex
+	std::thread _thread;
+	static std::mutex _sharedMutex;
+	//io_engine̵߳ļ¼Խstart/stop߳˳ʱɾ
+	static std::mutex _ringsMutex;
+	static std::vector<TraceRing_*> _rings;
+	static size_t _ringSize;
+};
+
+std::mutex TraceWriter_::_sharedMutex;
+std::mutex TraceWriter_::_ringsMutex;
+std::vector<TraceRing_*> TraceWriter_::_rings;
+size_t TraceWriter_::_ringSize = 0;
+std::atomic<bool> TraceAsync_::_running(false);
+static TraceWriter_* s_traceWriter = NULL;
+
+/*!
+@brief ǰio_engine߳еļ¼
+*/
+static TraceRing_*& trace_tls_ring(void** tlsBuff)
+{
+	return (TraceRing_*&)tlsBuff[TRACE_RING_TLS_INDEX];
+}
+
+/*!
+@brief ǰio_engine̵߳ļ¼ʱ
+*/
+static TraceRing_* trace_thread_ring()
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	if (!tlsBuff)
+	{
+		return NULL;
+	}
+	TraceRing_*& ring = trace_tls_ring(tlsBuff);
+	if (!ring)
+	{
+		std::lock_guard<std::mutex> lg(TraceWriter_::_ringsMutex);
+		ring = new TraceRing_(TraceWriter_::_ringSize);
+		TraceWriter_::_rings.push_back(ring);
+	}
+	return ring;
+}
+
+_Tracestream* TraceAsync_::acquire_stream()
+{
+	TraceRing_* const ring = trace_thread_ring();
+	if (ring && !ring->_streamBusy)
+	{
+		ring->_streamBusy = true;
+		return &ring->_stream;
+	}
+	return NULL;
+}
+
+void TraceAsync_::release_stream(_Tracestream* oss)
+{
+	TraceRing_* const ring = trace_tls_ring(io_engine::getTlsValueBuff());
+	assert(ring && &ring->_stream == oss);
+	oss->str(std::wstring());
+	oss->clear();
+	ring->_streamBusy = false;
+}
+
+void TraceAsync_::commit(_Tracestream& oss, bool endLine)
+{
+	if (_running.load(std::memory_order_relaxed))
+	{
+		TraceRing_* const ring = trace_thread_ring();
+		const std::wstring s = oss.str();
+		if (ring)
+		{
+			ring->_busy.store(true);
+			while (_running.load() && ring->fits(s, endLine))
+			{
+				if (ring->push(s_traceWriter->_seq++, s, endLine))
+				{
+					ring->_busy.store(false, std::memory_order_release);
+					return;
+				}
+				//д̺߳ȴ
+				s_traceWriter->notify();
+				std::this_thread::yield();
+			}
+			ring->_busy.store(false, std::memory_order_release);
+		}
+		else
+		{
+			while (true)
+			{
+				{
+					std::lock_guard<std::mutex> lg(TraceWriter_::_sharedMutex);
+					if (!_running.load() || !s_traceWriter->_sharedRing.fits(s, endLine))
+					{
+						break;
+					}
+					if (s_traceWriter->_sharedRing.push(s_traceWriter->_seq++, s, endLine))
+					{
+						return;
+					}
+					s_traceWriter->notify();
+				}
+				std::this_thread::yield();
+			}
+		}
+		TraceMutex_ mt;
+		if (endLine)
+		{
+			std::wcout << s << std::endl;
+		}
+		else
+		{
+			std::wcout << s << std::flush;
+		}
+		return;
+	}
+	TraceMutex_ mt;
+	if (endLine)
+	{
+		std::wcout << oss.str() << std::endl;
+	}
+	else
+	{
+		std::wcout << oss.str() << std::flush;
+	}
+}
+
+void TraceAsync_::tls_uninit()
+{
+	void** const tlsBuff = io_engine::getTlsValueBuff();
+	TraceRing_* const ring = tlsBuff ? trace_tls_ring(tlsBuff) : NULL;
+	if (ring)
+	{
+		trace_tls_ring(tlsBuff) = NULL;
+		std::lock_guard<std::mutex> lg(TraceWriter_::_ringsMutex);
+		if (s_traceWriter)
+		{//д߳дɾ
+			ring->_retired = true;
+		}
+		else
+		{
+			TraceWriter_::_rings.erase(std::find(TraceWriter_::_rings.begin(), TraceWriter_::_rings.end(), ring));
+			delete ring;
+		}
+	}
+}
+//////////////////////////////////////////////////////////////////////////
+
+bool trace_async_start(const char* path, int flushMs, size_t ringSize)
+{
+	assert(ringSize && 0 == (ringSize & (ringSize - 1)));
+	if (s_traceWriter)
+	{
+		return false;
+	}
+	ringSize = std::max(ringSize, (size_t)(4 * 1024));
+	TraceWriter_* writer = new TraceWriter_(path, std::max(1, flushMs), ringSize);
+	if (!writer->_out)
+	{
+		delete writer;
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lg(TraceWriter_::_ringsMutex);
+		TraceWriter_::_ringSize = ringSize;
+		s_traceWriter = writer;
+	}
+	writer->_thread = std::thread([writer]
+	{
+		writer->run();
+	});
+	TraceAsync_::_running.store(true);
+	return true;
+}
+
+void trace_async_flush()
+{
+	if (!TraceAsync_::_running.load())
+	{
+		return;
+	}
+	TraceWriter_* const writer = s_traceWriter;
+	std::unique_lock<std::mutex> ul(writer->_mutex);
+	//ȴһдִΣȡheadڵʱ
+	const unsigned long long passes = writer->_passes + 2;
+	while (writer->_passes < passes && !writer->_stop)
+	{
+		writer->_conVar.notify_one();
+		writer->_passConVar.wait(ul);
+	}
+}
+
+void trace_async_stop()
+{
+	if (!s_traceWriter)
+	{
+		return;
+	}
+	TraceAsync_::_running.store(false);
+	{
+		//ȴд뿪дڼ䲻ȡ_ringsMutex
+		std::lock_guard<std::mutex> lg1(TraceWriter_::_ringsMutex);
+		for (TraceRing_* ring : TraceWriter_::_rings)
+		{
+			while (ring->_busy.load())
+			{
+				std::this_thread::yield();
+			}
+		}
+		std::lock_guard<std::mutex> lg2(TraceWriter_::_sharedMutex);
+	}
+	{
+		std::lock_guard<std::mutex> lg(s_traceWriter->_mutex);
+		s_traceWriter->_stop = true;
+	}
+	s_traceWriter->notify();
+	s_traceWriter->_thread.join();
+	TraceWriter_* writer = s_traceWriter;
+	{
+		std::lock_guard<std::mutex> lg(TraceWriter_::_ringsMutex);
+		s_traceWriter = NULL;
+	}
+	TraceWriter_::clear_retired();
+	delete writer;
+}
+
+#endif
@@ -9,6 +9,8 @@
 #include <sstream>
 #include <iostream> 
 #include <mutex>
+#include <atomic>
+#include <type_traits>
 #include <tuple>
 #include <initializer_list>
 #include "try_move.h"
@@ -367,16 +369,93 @@ struct TraceMutex_
 
 #ifndef TRACE_ANDROID_LOG
 
-template <typename... Args> void trace(Args&&... args) { _Tracestream oss; _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::flush; } }
-template <typename... Args> void trace_line(Args&&... args) { _Tracestream oss; _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void trace_space(Args&&... args) { _Tracestream oss; _trace_space(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void trace_comma(Args&&... args) { _Tracestream oss; _trace_comma(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
+/*!
+@brief 첽־ˣtrace_async_starttraceֻѸʽõļ¼д̼߳¼ɺ̨߳д
+*/
+struct TraceAsync_
+{
+	static _Tracestream* acquire_stream();
+	static void release_stream(_Tracestream* oss);
+	static void commit(_Tracestream& oss, bool endLine);
+	static void tls_uninit();
+	static std::atomic<bool> _running;
+};
+
+/*!
+@brief ʽ첽ģʽ¸io_engine̻߳ÿ¼wostringstream
+*/
+struct TraceStream_
+{
+	TraceStream_()
+		:_oss(NULL), _cached(false)
+	{
+		if (TraceAsync_::_running.load(std::memory_order_relaxed))
+		{
+			_oss = TraceAsync_::acquire_stream();
+			_cached = !!_oss;
+		}
+		if (!_oss)
+		{
+			_oss = new(&_space)_Tracestream;
+		}
+	}
+
+	~TraceStream_()
+	{
+		if (_cached)
+		{
+			TraceAsync_::release_stream(_oss);
+		}
+		else
+		{
+			_oss->~_Tracestream();
+		}
+	}
+
+	operator _Tracestreambase&()
+	{
+		return *_oss;
+	}
+
+	void commit(bool endLine)
+	{
+		TraceAsync_::commit(*_oss, endLine);
+	}
+private:
+	_Tracestream* _oss;
+	bool _cached;
+	std::aligned_storage<sizeof(_Tracestream), std::alignment_of<_Tracestream>::value>::type _space;
+	TraceStream_(const TraceStream_&) = delete;
+	void operator=(const TraceStream_&) = delete;
+};
+
+/*!
+@brief 첽־pathΪNULLʱдstd::wcout
+@param flushMs ̨߳д
+@param ringSize ÿ¼ֽ(2)
+*/
+bool trace_async_start(const char* path = NULL, int flushMs = 50, size_t ringSize = 256 * 1024);
+
+/*!
+@brief ȴǰм¼дtrace_async_stop
+*/
+void trace_async_flush();
+
+/*!
+@brief дʣ¼ֹͣ첽־֮صͬ
+*/
+void trace_async_stop();
+
+template <typename... Args> void trace(Args&&... args) { TraceStream_ oss; _trace(oss, std::forward<Args>(args)...); oss.commit(false); }
+template <typename... Args> void trace_line(Args&&... args) { TraceStream_ oss; _trace(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void trace_space(Args&&... args) { TraceStream_ oss; _trace_space(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void trace_comma(Args&&... args) { TraceStream_ oss; _trace_comma(oss, std::forward<Args>(args)...); oss.commit(true); }
 
 #if (_DEBUG || DEBUG)
-template <typename... Args> void debug_trace(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::flush; } }
-template <typename... Args> void debug_trace_line(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void debug_trace_space(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace_space(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void debug_trace_comma(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace_comma(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
+template <typename... Args> void debug_trace(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace(oss, std::forward<Args>(args)...); oss.commit(false); }
+template <typename... Args> void debug_trace_line(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void debug_trace_space(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace_space(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void debug_trace_comma(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " DEBUG:   "); _trace_comma(oss, std::forward<Args>(args)...); oss.commit(true); }
 #else
 #define debug_trace(...)
 #define debug_trace_line(...)
@@ -384,20 +463,20 @@ template <typename... Args> void debug_trace_comma(Args&&... args) { _Tracestrea
 #define debug_trace_comma(...)
 #endif
 
-template <typename... Args> void info_trace(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::flush; } }
-template <typename... Args> void info_trace_line(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void info_trace_space(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace_space(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void info_trace_comma(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace_comma(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
+template <typename... Args> void info_trace(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace(oss, std::forward<Args>(args)...); oss.commit(false); }
+template <typename... Args> void info_trace_line(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void info_trace_space(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace_space(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void info_trace_comma(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " INFO:    "); _trace_comma(oss, std::forward<Args>(args)...); oss.commit(true); }
 
-template <typename... Args> void error_trace(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::flush; } }
-template <typename... Args> void error_trace_line(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void error_trace_space(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace_space(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void error_trace_comma(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace_comma(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
+template <typename... Args> void error_trace(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace(oss, std::forward<Args>(args)...); oss.commit(false); }
+template <typename... Args> void error_trace_line(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void error_trace_space(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace_space(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void error_trace_comma(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " ERROR:   "); _trace_comma(oss, std::forward<Args>(args)...); oss.commit(true); }
 
-template <typename... Args> void warning_trace(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::flush; } }
-template <typename... Args> void warning_trace_line(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void warning_trace_space(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace_space(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
-template <typename... Args> void warning_trace_comma(Args&&... args) { _Tracestream oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace_comma(oss, std::forward<Args>(args)...); { TraceMutex_ mt; std::wcout << oss.str() << std::endl; } }
+template <typename... Args> void warning_trace(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace(oss, std::forward<Args>(args)...); oss.commit(false); }
+template <typename... Args> void warning_trace_line(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void warning_trace_space(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace_space(oss, std::forward<Args>(args)...); oss.commit(true); }
+template <typename... Args> void warning_trace_comma(Args&&... args) { TraceStream_ oss; print_time_ms(oss); _trace(oss, " WARNING: "); _trace_comma(oss, std::forward<Args>(args)...); oss.commit(true); }
 
 #else
 
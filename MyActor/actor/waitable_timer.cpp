@@ -1,84 +1,65 @@
 #ifdef DISABLE_BOOST_TIMER
 #include "waitable_timer.h"
 #include "scattered.h"
+#include "io_engine.h"
+#include <climits>
 #ifdef WIN32
 #include <Windows.h>
 
-WaitableTimer_::WaitableTimer_()
-:_eventsQueue(1024), _exited(false), _extMaxTick(0), _extFinishTime(-1),
-_timerHandle(CreateWaitableTimer(NULL, FALSE, NULL))
+WaitableTimer_::timer_shard::timer_shard()
+:_submitHead(NULL), _extFinishTime(LLONG_MAX), _eventsQueue(1024), _extMaxTick(0),
+_timerHandle(CreateWaitableTimer(NULL, FALSE, NULL)), _wakeHandle(CreateEvent(NULL, FALSE, FALSE, NULL))
 {
-	run_thread th([this] { timerThread(); });
-	_timerThread.swap(th);
+	_expiredEvents.reserve(64);
 }
 
-WaitableTimer_::~WaitableTimer_()
+WaitableTimer_::timer_shard::~timer_shard()
 {
-	{
-		std::lock_guard<std::mutex> lg(_ctrlMutex);
-		assert(_eventsQueue.empty());
-		_exited = true;
-		LARGE_INTEGER sleepTime;
-		sleepTime.QuadPart = 0;
-		SetWaitableTimer(_timerHandle, &sleepTime, 0, NULL, NULL, FALSE);
-	}
-	_timerThread.join();
+	assert(_eventsQueue.empty());
 	CloseHandle(_timerHandle);
+	CloseHandle(_wakeHandle);
 }
 
-void WaitableTimer_::appendEvent(long long abs, long long rel, WaitableTimerEvent_* h)
+void WaitableTimer_::wakeShard(timer_shard* shard)
 {
-	assert(h->_timerHandle._null);
-	h->_timerHandle._null = false;
-	std::lock_guard<std::mutex> lg(_ctrlMutex);
-	if (abs >= _extMaxTick)
-	{
-		_extMaxTick = abs;
-		h->_timerHandle._queueNode = _eventsQueue.insert(_eventsQueue.end(), std::make_pair(abs, h));
-	}
-	else
-	{
-		h->_timerHandle._queueNode = _eventsQueue.insert(std::make_pair(abs, h));
-	}
-	if ((unsigned long long)abs < (unsigned long long)_extFinishTime)
-	{
-		_extFinishTime = abs;
-		LARGE_INTEGER sleepTime;
-		sleepTime.QuadPart = -(LONGLONG)(rel * 10);
-		SetWaitableTimer(_timerHandle, &sleepTime, 0, NULL, NULL, FALSE);
-	}
+	SetEvent(shard->_wakeHandle);
 }
 
-void WaitableTimer_::timerThread()
+void WaitableTimer_::timerThread(timer_shard* shard)
 {
 	run_thread::set_current_thread_name("waitable timer thread");
 	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
-	while (true)
+	HANDLE handles[2] = { shard->_timerHandle, shard->_wakeHandle };
+	long long armedTime = LLONG_MAX;
+	while (!_exited)
 	{
-		if (WAIT_OBJECT_0 == WaitForSingleObject(_timerHandle, INFINITE) && !_exited)
+		long long nextTime;
+		do
+		{
+			shard->_extFinishTime = 0;
+			nextTime = runShard(shard);
+			shard->_extFinishTime = nextTime;
+		} while (shard->_submitHead);
+		if (nextTime != armedTime)
 		{
-			long long ct = get_tick_us();
-			std::lock_guard<std::mutex> lg(_ctrlMutex);
-			_extFinishTime = -1;
-			while (!_eventsQueue.empty())
+			armedTime = nextTime;
+			if (LLONG_MAX == nextTime)
 			{
-				handler_queue::iterator iter = _eventsQueue.begin();
-				if (iter->first > ct)
-				{
-					_extFinishTime = iter->first;
-					LARGE_INTEGER sleepTime;
-					sleepTime.QuadPart = -(LONGLONG)((iter->first - ct) * 10);
-					SetWaitableTimer(_timerHandle, &sleepTime, 0, NULL, NULL, FALSE);
-					break;
-				} 
-				else
-				{
-					iter->second->eventHandler();
-					_eventsQueue.erase(iter);
-				}
+				CancelWaitableTimer(shard->_timerHandle);
 			}
-		} 
-		else
+			else
+			{
+				LARGE_INTEGER sleepTime;
+				sleepTime.QuadPart = -(LONGLONG)(std::max(nextTime - get_tick_us(), (long long)1) * 10);
+				SetWaitableTimer(shard->_timerHandle, &sleepTime, 0, NULL, NULL, FALSE);
+			}
+		}
+		DWORD waitRes = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+		if (WAIT_OBJECT_0 == waitRes)
+		{//ʱѵڣ´Ҫ
+			armedTime = LLONG_MAX;
+		}
+		else if (WAIT_OBJECT_0 + 1 != waitRes)
 		{
 			break;
 		}
@@ -86,55 +67,30 @@ void WaitableTimer_::timerThread()
 }
 #elif __linux__
 #include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <poll.h>
 #include <pthread.h>
 
-WaitableTimer_::WaitableTimer_()
-:_eventsQueue(1024), _exited(false), _extMaxTick(0), _extFinishTime(-1),
-_timerFd(timerfd_create(CLOCK_MONOTONIC, 0))
+WaitableTimer_::timer_shard::timer_shard()
+:_submitHead(NULL), _extFinishTime(LLONG_MAX), _eventsQueue(1024), _extMaxTick(0),
+_timerFd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK)), _wakeFd(eventfd(0, EFD_NONBLOCK))
 {
-	run_thread th([this] { timerThread(); });
-	_timerThread.swap(th);
+	_expiredEvents.reserve(64);
 }
 
-WaitableTimer_::~WaitableTimer_()
+WaitableTimer_::timer_shard::~timer_shard()
 {
-	{
-		std::lock_guard<std::mutex> lg(_ctrlMutex);
-		assert(_eventsQueue.empty());
-		_exited = true;
-		struct itimerspec newValue = { { 0, 0 }, { 0, 1 } };
-		timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &newValue, NULL);
-	}
-	_timerThread.join();
+	assert(_eventsQueue.empty());
 	close(_timerFd);
+	close(_wakeFd);
 }
 
-void WaitableTimer_::appendEvent(long long abs, long long rel, WaitableTimerEvent_* h)
+void WaitableTimer_::wakeShard(timer_shard* shard)
 {
-	assert(h->_timerHandle._null);
-	h->_timerHandle._null = false;
-	std::lock_guard<std::mutex> lg(_ctrlMutex);
-	if (abs >= _extMaxTick)
-	{
-		_extMaxTick = abs;
-		h->_timerHandle._queueNode = _eventsQueue.insert(_eventsQueue.end(), std::make_pair(abs, h));
-	}
-	else
-	{
-		h->_timerHandle._queueNode = _eventsQueue.insert(std::make_pair(abs, h));
-	}
-	if ((unsigned long long)abs < (unsigned long long)_extFinishTime)
-	{
-		_extFinishTime = abs;
-		struct itimerspec newValue;
-		newValue.it_interval = { 0, 0 };
-		newValue.it_value.tv_sec = (__time_t)(abs / 1000000);
-		newValue.it_value.tv_nsec = (long)(abs % 1000000) * 1000;
-		timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &newValue, NULL);
-	}
+	eventfd_write(shard->_wakeFd, 1);
 }
 
-void WaitableTimer_::timerThread()
+void WaitableTimer_::timerThread(timer_shard* shard)
 {
 	run_thread::set_current_thread_name("waitable timer thread");
 	pthread_attr_t threadAttr;
@@ -142,105 +98,282 @@ void WaitableTimer_::timerThread()
 	pthread_attr_init(&threadAttr);
 	pthread_attr_setschedpolicy(&threadAttr, SCHED_FIFO);
 	pthread_attr_setschedparam(&threadAttr, &pm);
-	long long exp = 0;
-	while (true)
+	struct pollfd fds[2] = { { shard->_timerFd, POLLIN, 0 }, { shard->_wakeFd, POLLIN, 0 } };
+	long long armedTime = LLONG_MAX;
+	while (!_exited)
 	{
-		if (sizeof(exp) == read(_timerFd, &exp, sizeof(exp)) && !_exited)
+		long long nextTime;
+		do
 		{
-			long long ct = get_tick_us();
-			std::lock_guard<std::mutex> lg(_ctrlMutex);
-			_extFinishTime = -1;
-			while (!_eventsQueue.empty())
+			shard->_extFinishTime = 0;
+			nextTime = runShard(shard);
+			shard->_extFinishTime = nextTime;
+		} while (shard->_submitHead);
+		if (nextTime != armedTime)
+		{
+			armedTime = nextTime;
+			struct itimerspec newValue = { { 0, 0 }, { 0, 0 } };
+			if (LLONG_MAX != nextTime)
 			{
-				handler_queue::iterator iter = _eventsQueue.begin();
-				if (iter->first > ct)
-				{
-					_extFinishTime = iter->first;
-					struct itimerspec newValue;
-					newValue.it_interval = { 0, 0 };
-					newValue.it_value.tv_sec = (__time_t)(_extFinishTime / 1000000);
-					newValue.it_value.tv_nsec = (long)(_extFinishTime % 1000000) * 1000;
-					timerfd_settime(_timerFd, TFD_TIMER_ABSTIME, &newValue, NULL);
-					break;
-				}
-				else
+				newValue.it_value.tv_sec = (__time_t)(nextTime / 1000000);
+				newValue.it_value.tv_nsec = (long)(nextTime % 1000000) * 1000;
+				if (!newValue.it_value.tv_sec && !newValue.it_value.tv_nsec)
 				{
-					iter->second->eventHandler();
-					_eventsQueue.erase(iter);
+					newValue.it_value.tv_nsec = 1;
 				}
 			}
+			timerfd_settime(shard->_timerFd, TFD_TIMER_ABSTIME, &newValue, NULL);
 		}
-		else
+		if (poll(fds, 2, -1) > 0)
 		{
-			break;
+			long long exp = 0;
+			if (sizeof(exp) == read(shard->_timerFd, &exp, sizeof(exp)))
+			{//ʱѵڣ´Ҫ
+				armedTime = LLONG_MAX;
+			}
+			eventfd_t val;
+			eventfd_read(shard->_wakeFd, &val);
 		}
 	}
 	pthread_attr_destroy(&threadAttr);
 }
 #endif
 
-void WaitableTimer_::removeEvent(timer_handle& th)
+WaitableTimer_::WaitableTimer_()
+:_shardSelect(0), _exited(false)
+{
+	size_t shardNum = WAITABLE_TIMER_SHARDS;
+	if (!shardNum)
+	{
+		shardNum = std::max((size_t)1, std::min(run_thread::cpu_thread_number(), (size_t)WAITABLE_TIMER_MAX_SHARDS));
+	}
+	_shards.resize(shardNum);
+	for (size_t i = 0; i < shardNum; i++)
+	{
+		timer_shard* const shard = new timer_shard;
+		run_thread th([this, shard] { timerThread(shard); });
+		shard->_timerThread.swap(th);
+		_shards[i] = shard;
+	}
+}
+
+WaitableTimer_::~WaitableTimer_()
+{
+	_exited = true;
+	for (timer_shard* const shard : _shards)
+	{
+		wakeShard(shard);
+		shard->_timerThread.join();
+		//ͷ˳ǰύѷ¼
+		runShard(shard);
+		assert(!shard->_submitHead);
+		delete shard;
+	}
+	_shards.clear();
+}
+
+WaitableTimer_::timer_shard* WaitableTimer_::selectShard()
+{
+	return _shards[_shardSelect++ % _shards.size()];
+}
+
+void WaitableTimer_::submitEvent(timer_shard* shard, WaitableTimerEvent_* h, long long abs)
+{
+	if (!h->_submited.exchange(true))
+	{
+		pushSubmit(shard, h);
+	}
+	preemptShard(shard, abs);
+}
+
+void WaitableTimer_::pushSubmit(timer_shard* shard, WaitableTimerEvent_* h)
+{
+	assert(h->_submited);
+	WaitableTimerEvent_* head = shard->_submitHead;
+	do
+	{
+		h->_submitNext = head;
+	} while (!shard->_submitHead.compare_exchange_weak(head, h));
+}
+
+void WaitableTimer_::preemptShard(timer_shard* shard, long long abs)
+{
+	//Ƭ߳ڵȴޣռȨ(еķƬ߳_extFinishTimeΪ0˯ǰټύ)
+	long long extFinishTime = shard->_extFinishTime;
+	while (abs < extFinishTime)
+	{
+		if (shard->_extFinishTime.compare_exchange_weak(extFinishTime, 0))
+		{
+			wakeShard(shard);
+			break;
+		}
+	}
+}
+
+void WaitableTimer_::removeEvent(timer_shard* shard, timer_handle& th)
 {
-	std::lock_guard<std::mutex> lg(_ctrlMutex);
 	if (!th._null)
 	{
 		th._null = true;
+		handler_queue& eventsQueue = shard->_eventsQueue;
 		auto itNode = th._queueNode;
-		if (_eventsQueue.size() == 1)
+		if (eventsQueue.size() == 1)
 		{
-			_extMaxTick = 0;
-			_extFinishTime = -1;
-			_eventsQueue.erase(itNode);
+			shard->_extMaxTick = 0;
+			eventsQueue.erase(itNode);
 		}
-		else if (itNode->first == _extMaxTick)
+		else if (itNode->first == shard->_extMaxTick)
 		{
-			_eventsQueue.erase(itNode++);
-			if (_eventsQueue.end() == itNode)
+			eventsQueue.erase(itNode++);
+			if (eventsQueue.end() == itNode)
 			{
 				itNode--;
 			}
-			_extMaxTick = itNode->first;
+			shard->_extMaxTick = itNode->first;
 		}
 		else
 		{
-			_eventsQueue.erase(itNode);
+			eventsQueue.erase(itNode);
+		}
+	}
+}
+
+void WaitableTimer_::updateEvent(timer_shard* shard, WaitableTimerEvent_* h)
+{
+	while (true)
+	{
+		removeEvent(shard, h->_timerHandle);
+		const int waitID = h->_waitState;
+		if (WaitableTimerEvent_::wait_detach == waitID)
+		{//ѷ¼ڼ_submitedΪtrueٴɷƬ߳ͷ
+			delete h;
+			return;
+		}
+		if (WaitableTimerEvent_::wait_triged != waitID)
+		{
+			const long long abs = h->_deadline.load(std::memory_order_relaxed);
+			const int tc = h->_tcId.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (waitID == h->_waitState.load(std::memory_order_relaxed))
+			{//ȡڼ״̬޸Ĺ¼
+				timer_handle& th = h->_timerHandle;
+				th._null = false;
+				th._waitID = waitID;
+				th._tcId = tc;
+				handler_queue& eventsQueue = shard->_eventsQueue;
+				if (abs >= shard->_extMaxTick)
+				{
+					shard->_extMaxTick = abs;
+					th._queueNode = eventsQueue.insert(eventsQueue.end(), std::make_pair(abs, h));
+				}
+				else
+				{
+					th._queueNode = eventsQueue.insert(std::make_pair(abs, h));
+				}
+			}
+		}
+		//ɺύǣڼύˣ״̬б仯ʱ´(ѱύ)
+		h->_submited = false;
+		if (waitID == h->_waitState || h->_submited.exchange(true))
+		{
+			return;
 		}
 	}
 }
+
+long long WaitableTimer_::runShard(timer_shard* shard)
+{
+	WaitableTimerEvent_* h = shard->_submitHead.exchange(NULL);
+	while (h)
+	{
+		WaitableTimerEvent_* const next = h->_submitNext;
+		updateEvent(shard, h);
+		h = next;
+	}
+	long long ct = get_tick_us();
+	handler_queue& eventsQueue = shard->_eventsQueue;
+	while (!eventsQueue.empty())
+	{
+		handler_queue::iterator iter = eventsQueue.begin();
+		if (iter->first > ct)
+		{
+			break;
+		}
+		WaitableTimerEvent_* const eh = iter->second;
+		expired_event ee = { eh, eh->_timerHandle._waitID, eh->_timerHandle._tcId };
+		shard->_expiredEvents.push_back(ee);
+		removeEvent(shard, eh->_timerHandle);
+	}
+	//ӺɷȡͬһȴIDֻһܴpost_event
+	for (expired_event& ee : shard->_expiredEvents)
+	{
+		int waitID = ee._waitID;
+		if (ee._event->_waitState.compare_exchange_strong(waitID, WaitableTimerEvent_::wait_triged))
+		{
+			ee._event->_timerBoost->post_event(ee._tcId);
+		}
+	}
+	shard->_expiredEvents.clear();
+	return eventsQueue.empty() ? LLONG_MAX : eventsQueue.begin()->first;
+}
 //////////////////////////////////////////////////////////////////////////
 
 WaitableTimerEvent_::WaitableTimerEvent_(io_engine& ios, TimerBoostCompletedEventFace_* timerBoost)
-:_ios(ios), _timerBoost(timerBoost), _tcId(-1), _triged(true) {}
+:_ios(ios), _shard(ios._waitableTimer->selectShard()), _timerBoost(timerBoost), _submitNext(NULL),
+_deadline(0), _tcId(-1), _waitState(wait_triged), _submited(false), _waitID(0) {}
 
 WaitableTimerEvent_::~WaitableTimerEvent_()
 {
-	assert(_triged);
+	assert(wait_detach == _waitState || !_waitID);
 }
 
-void WaitableTimerEvent_::eventHandler()
+void WaitableTimerEvent_::destroy()
 {
-	_timerHandle.reset();
-	_triged = true;
-	_timerBoost->post_event(_tcId);
+	assert(wait_triged == _waitState);
+	if (_waitID)
+	{//Ƭ߳̿ñ¼Ƭ߳ͷţȴ
+		//ȡύٷwait_detach֮Ƭ߳ʱͷű¼ٷthis
+		WaitableTimer_* const waitableTimer = _ios._waitableTimer;
+		WaitableTimer_::timer_shard* const shard = _shard;
+		if (!_submited.exchange(true))
+		{//ɱ߳ɹ󼴽Ȩ
+			_waitState = wait_detach;
+			waitableTimer->pushSubmit(shard, this);
+		}
+		else
+		{//ύлڱƬ̴߳ʱ¼鵽wait_detach
+			_waitState = wait_detach;
+		}
+		waitableTimer->preemptShard(shard, LLONG_MIN);
+	}
+	else
+	{
+		delete this;
+	}
 }
 
 void WaitableTimerEvent_::cancel(boost::system::error_code& ec)
 {
 	ec.clear();
-	_ios._waitableTimer->removeEvent(_timerHandle);
-	if (!_triged)
-	{
-		_triged = true;
-		_timerBoost->post_event(_tcId);
+	int waitID = _waitID;
+	if (_waitState.compare_exchange_strong(waitID, wait_triged))
+	{//δύƬ̳߳(Ҫ)
+		_ios._waitableTimer->submitEvent(_shard, this, LLONG_MAX);
+		_timerBoost->post_event(_tcId.load(std::memory_order_relaxed));
 	}
 }
 
 void WaitableTimerEvent_::async_wait(long long abs, long long rel, int tc)
 {
-	assert(_triged);
-	_triged = false;
-	_tcId = tc;
-	_ios._waitableTimer->appendEvent(abs, rel, this);
+	assert(wait_triged == _waitState);
+	if (++_waitID <= 0)
+	{
+		_waitID = 1;
+	}
+	_deadline.store(abs, std::memory_order_relaxed);
+	_tcId.store(tc, std::memory_order_relaxed);
+	_waitState = _waitID;
+	_ios._waitableTimer->submitEvent(_shard, this, abs);
 }
 
-#endif
\ No newline at end of file
+#endif
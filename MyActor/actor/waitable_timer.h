@@ -2,6 +2,8 @@
 #define __WAITABLE_TIMER_H
 
 #ifdef DISABLE_BOOST_TIMER
+#include <atomic>
+#include <vector>
 #include "msg_queue.h"
 #include "mem_pool.h"
 #include "run_strand.h"
@@ -11,10 +13,23 @@ class ActorTimer_;
 class WaitableTimerEvent_;
 class overlap_timer;
 
+//ʱƬ0ʾCPU߳Զѡ
+#ifndef WAITABLE_TIMER_SHARDS
+#define WAITABLE_TIMER_SHARDS 0
+#endif
+
+//ԶѡʱƬ
+#ifndef WAITABLE_TIMER_MAX_SHARDS
+#define WAITABLE_TIMER_MAX_SHARDS 8
+#endif
+
 class WaitableTimer_
 {
 	typedef msg_multimap<long long, WaitableTimerEvent_*> handler_queue;
 
+	/*!
+	@brief ֻƬ̷߳ʵŶϢ
+	*/
 	struct timer_handle
 	{
 		void reset()
@@ -23,29 +38,60 @@ class WaitableTimer_
 		}
 
 		bool _null = true;
+		int _waitID = 0;
+		int _tcId = -1;
 		handler_queue::iterator _queueNode;
 	};
 
+	struct expired_event
+	{
+		WaitableTimerEvent_* _event;
+		int _waitID;
+		int _tcId;
+	};
+
+	/*!
+	@brief һʱƬĶʱ߳/ں˶ʱ
+	µĶʱͨMPSCύֻзƬ̷߳ʶʱ
+	*/
+	struct timer_shard
+	{
+		timer_shard();
+		~timer_shard();
+
+		std::atomic<WaitableTimerEvent_*> _submitHead;
+		std::atomic<long long> _extFinishTime;
+		handler_queue _eventsQueue;
+		std::vector<expired_event> _expiredEvents;
+		long long _extMaxTick;
+		run_thread _timerThread;
+#ifdef WIN32
+		void* _timerHandle;
+		void* _wakeHandle;
+#elif __linux__
+		int _timerFd;
+		int _wakeFd;
+#endif
+	};
+
 	friend io_engine;
 	friend WaitableTimerEvent_;
 private:
 	WaitableTimer_();
 	~WaitableTimer_();
 private:
-	void appendEvent(long long abs, long long rel, WaitableTimerEvent_* h);
-	void removeEvent(timer_handle& th);
-	void timerThread();
+	timer_shard* selectShard();
+	void submitEvent(timer_shard* shard, WaitableTimerEvent_* h, long long abs);
+	void pushSubmit(timer_shard* shard, WaitableTimerEvent_* h);
+	void preemptShard(timer_shard* shard, long long abs);
+	void wakeShard(timer_shard* shard);
+	void updateEvent(timer_shard* shard, WaitableTimerEvent_* h);
+	void removeEvent(timer_shard* shard, timer_handle& th);
+	long long runShard(timer_shard* shard);
+	void timerThread(timer_shard* shard);
 private:
-	long long _extMaxTick;
-	long long _extFinishTime;
-	handler_queue _eventsQueue;
-	std::mutex _ctrlMutex;
-	run_thread _timerThread;
-#ifdef WIN32
-	void* _timerHandle;
-#elif __linux__
-	int _timerFd;
-#endif
+	std::vector<timer_shard*> _shards;
+	std::atomic<size_t> _shardSelect;
 	volatile bool _exited;
 	NONE_COPY(WaitableTimer_);
 };
@@ -55,19 +101,34 @@ class WaitableTimerEvent_
 	friend ActorTimer_;
 	friend WaitableTimer_;
 	friend overlap_timer;
+
+	enum
+	{
+		wait_triged = 0,
+		wait_detach = -1
+	};
 private:
 	WaitableTimerEvent_(io_engine& ios, TimerBoostCompletedEventFace_* timerBoost);
 	~WaitableTimerEvent_();
 private:
-	void eventHandler();
+	/*!
+	@brief deleteύ¼ɷƬ̴߳ͷ
+	*/
+	void destroy();
 	void cancel(boost::system::error_code& ec);
 	void async_wait(long long abs, long long rel, int tc);
 private:
 	io_engine& _ios;
-	WaitableTimer_::timer_handle _timerHandle;
+	WaitableTimer_::timer_shard* _shard;
 	TimerBoostCompletedEventFace_* _timerBoost;
-	int _tcId;
-	bool _triged;
+	WaitableTimer_::timer_handle _timerHandle;
+	WaitableTimerEvent_* _submitNext;
+	std::atomic<long long> _deadline;
+	std::atomic<int> _tcId;
+	//ǰȴIDwait_trigedʾѴȡ
+	std::atomic<int> _waitState;
+	std::atomic<bool> _submited;
+	int _waitID;
 	NONE_COPY(WaitableTimerEvent_);
 };
 #endif